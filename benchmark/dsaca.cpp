@@ -6,82 +6,128 @@
  * All rights reserved. Published under the BSD-2 license in the LICENSE file.
  ******************************************************************************/
 
+#include <cstdint>
+#include <fstream>
+#include <limits>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 #include <tlx/cmdline_parser.hpp>
 
 #include "mpi/allreduce.hpp"
+#include "mpi/checkpoint.hpp"
 #include "mpi/distribute_input.hpp"
 #include "mpi/environment.hpp"
+#include "mpi/packed_data.hpp"
 
+#include "suffix_sorting/bwt.hpp"
+#include "suffix_sorting/difference_cover.hpp"
 #include "suffix_sorting/inducing.hpp"
+#include "suffix_sorting/inverse_suffix_array.hpp"
+#include "suffix_sorting/lcp.hpp"
 #include "suffix_sorting/prefix_doubling.hpp"
 #include "suffix_sorting/sa_check.hpp"
 
+#include "util/mapped_file.hpp"
 #include "util/random_string_generator.hpp"
+#include "util/spill_vector.hpp"
 #include "util/string.hpp"
 #include "util/uint_types.hpp"
 
 size_t string_size = { 0 };
 std::string input_path = "";
 std::string output_path = "";
+std::string lcp_output_path = "";
+std::string bwt_output_path = "";
+std::string isa_output_path = "";
 bool check = false;
+bool packed_output = false;
+bool split_output = false;
+double check_sample_ratio = 0.0;
 bool doubling_discarding = false;
+size_t dcx_size = 0;
+bool recursive_bs_ranking = false;
+size_t max_bs_substring_length = 0;
+size_t index_bits = 0;
+size_t threads = 0;
+size_t halo_size = dsss::mpi::default_halo_size;
+bool memory_map = false;
+dsss::mapped_file input_file;
+dsss::spill_config spill;
+dsss::mpi::checkpoint_config checkpoint;
+dsss::mpi::io_hints io_hints;
 
-int32_t main(int32_t argc, char const *argv[]) {
-  dsss::mpi::environment env;
-  tlx::CmdlineParser cp;
-
-  using index_type = dsss::uint40;
-  // using index_type = size_t;
-
-  cp.set_description("Distributed Suffix Array Construction");
-  cp.set_author("Florian Kurpicz <florian.kurpicz@tu-dortmund.de>");
-
-  cp.add_param_string("input", input_path,
-                      "Path to input file. The special input 'random' generates"
-                      " a random text of the size given by parameter '-s'.");
-
-  cp.add_bytes('s', "size", string_size, "Size (in bytes unless stated "
-               "otherwise) of the string that use to test our suffix array "
-               "construction algorithms.");
-
-  cp.add_flag('c', "check", check, "Check if the SA has been constructed "
-              "correctly. This does not work with random text (no way to "
-              " reproduce).");
+// Writes the SA, ISA, or LCP array in the output format chosen by the user.
+template <typename DataType>
+void write_output(std::vector<DataType>& data, const std::string& path) {
+  if (split_output) {
+    dsss::mpi::write_split_data(data, path);
+  } else if (packed_output) {
+    dsss::mpi::write_packed_data(data, path, io_hints);
+  } else {
+    dsss::mpi::write_data(data, path, io_hints);
+  }
+}
 
-  cp.add_string('o', "output", "<F>", output_path, "Filename for the output "
-                "(SA). Note that the output is five times larger than the input"
-                " file.");
+// Returns the local slice of the text (again), either read from the input
+// file or copied from the memory-mapped input file.
+std::vector<dsss::char_type> local_text() {
+  if (memory_map) {
+    return dsss::to_distributed_string(
+      dsss::mpi::map_string(input_file, string_size)).string;
+  }
+  return dsss::mpi::distribute_string(input_path, string_size).string;
+}
 
-  cp.add_flag('d', "discarding", doubling_discarding, "Compute the suffix array"
-              " using prefix doubling with discarding (instead of inducing).");
+// Computes the SA (and all requested outputs) using index_type for all
+// indices. The text has already been distributed.
+template <typename index_type, typename distributed_text>
+void compute_suffix_array(distributed_text&& distributed_strings,
+  dsss::mpi::environment env = dsss::mpi::environment()) {
 
-  if (!cp.process(argc, argv)) {
-    return -1;
-  }
+  // Prefix doubling can compute the ISA instead of the SA, if nothing else
+  // requires the SA.
+  const bool isa_only = !isa_output_path.empty() && output_path.empty() &&
+    bwt_output_path.empty() && lcp_output_path.empty() && !check;
+  bool isa_computed = false;
 
-  dsss::distributed_string distributed_strings;
+  dsss::suffix_sorting::doubling_config doubling;
+  doubling.spill = spill;
+  doubling.checkpoint = checkpoint;
 
-  if (!input_path.compare("random")) {
-    string_size /= env.size();
-    dsss::random_indexed_string_set<index_type> rss(string_size, 255);
-    distributed_strings = { env.rank() * string_size,
-      std::move(rss.data_container()) };
-  } else {
-    if (string_size > 0) {
-      distributed_strings = dsss::mpi::distribute_string(
-        input_path, string_size);
-    } else {
-      distributed_strings = dsss::mpi::distribute_string(input_path);
-    }
-  }
   std::vector<index_type> sa;
+  std::vector<index_type> isa;
   auto start_time = MPI_Wtime();
-  if (doubling_discarding) {
+  if (doubling_discarding && isa_only) {
+    isa = dsss::suffix_sorting::prefix_doubling_discarding<index_type, true>(
+            std::move(distributed_strings), doubling);
+    isa_computed = true;
+  } else if (doubling_discarding) {
     sa = dsss::suffix_sorting::prefix_doubling_discarding<index_type>(
-           std::move(distributed_strings));
+           std::move(distributed_strings), doubling);
+  } else if (dcx_size == 3) {
+    sa = dsss::suffix_sorting::dcx<index_type, 3>(
+           dsss::to_distributed_string(std::move(distributed_strings)));
+  } else if (dcx_size == 7) {
+    sa = dsss::suffix_sorting::dcx<index_type, 7>(
+           dsss::to_distributed_string(std::move(distributed_strings)));
+  } else if (dcx_size == 13) {
+    sa = dsss::suffix_sorting::dcx<index_type, 13>(
+           dsss::to_distributed_string(std::move(distributed_strings)));
+  } else if (dcx_size == 21) {
+    sa = dsss::suffix_sorting::dcx<index_type, 21>(
+           dsss::to_distributed_string(std::move(distributed_strings)));
   } else /*inducing*/ {
+    dsss::suffix_sorting::inducing_config config;
+    config.recursive_bs_ranking = recursive_bs_ranking;
+    config.max_bs_substring_length = max_bs_substring_length;
+    config.spill = spill;
+    config.checkpoint = checkpoint;
     sa = dsss::suffix_sorting::inducing<index_type>(
-           std::move(distributed_strings));
+           dsss::to_distributed_string(std::move(distributed_strings)),
+           config);
   }
   auto end_time = MPI_Wtime();
 
@@ -93,39 +139,304 @@ int32_t main(int32_t argc, char const *argv[]) {
     if (env.rank() == 0) {
       std::cout <<"Writing the SA to " << output_path << std::endl;
     }
-    dsss::mpi::write_data(sa, output_path);
+    write_output(sa, output_path);
     env.barrier();
     if (env.rank() == 0) {
       std::cout << "Finished writing the SA" << std::endl;
     }
   }
 
-  if (check) {
-    if (string_size > 0) {
-      distributed_strings = dsss::mpi::distribute_string(input_path,
-                                                         string_size);
+  if (!isa_output_path.empty()) {
+    if (!isa_computed) {
+      start_time = MPI_Wtime();
+      isa = dsss::suffix_sorting::inverse_suffix_array(sa);
+      end_time = MPI_Wtime();
+      if (env.rank() == 0) {
+        std::cout << "ISA TIME: " << end_time - start_time << std::endl;
+      }
+    }
+    if (env.rank() == 0) {
+      std::cout <<"Writing the ISA to " << isa_output_path << std::endl;
+    }
+    write_output(isa, isa_output_path);
+    env.barrier();
+    if (env.rank() == 0) {
+      std::cout << "Finished writing the ISA" << std::endl;
+    }
+  }
+
+  if (!bwt_output_path.empty()) {
+    std::vector<dsss::char_type> text = local_text();
+    start_time = MPI_Wtime();
+    auto [ bwt, primary_index ] =
+      dsss::suffix_sorting::bwt(sa, text);
+    end_time = MPI_Wtime();
+    if (env.rank() == 0) {
+      std::cout << "BWT TIME: " << end_time - start_time << std::endl;
+      std::cout <<"Writing the BWT to " << bwt_output_path << std::endl;
+    }
+    if (split_output) {
+      dsss::mpi::write_split_data(bwt, bwt_output_path);
     } else {
-      distributed_strings = dsss::mpi::distribute_string(input_path);
+      dsss::mpi::write_data(bwt, bwt_output_path, io_hints);
+    }
+    if (env.rank() == 0) {
+      std::ofstream primary_stream(bwt_output_path + ".primary");
+      primary_stream << primary_index << std::endl;
     }
+    env.barrier();
+    if (env.rank() == 0) {
+      std::cout << "Finished writing the BWT (primary index "
+                << primary_index << ")" << std::endl;
+    }
+  }
+
+  if (!lcp_output_path.empty()) {
+    std::vector<dsss::char_type> text = local_text();
+    start_time = MPI_Wtime();
+    auto lcp = dsss::suffix_sorting::lcp_array(sa, text);
+    end_time = MPI_Wtime();
+    if (env.rank() == 0) {
+      std::cout << "LCP TIME: " << end_time - start_time << std::endl;
+      std::cout <<"Writing the LCP array to " << lcp_output_path << std::endl;
+    }
+    write_output(lcp, lcp_output_path);
+    env.barrier();
+    if (env.rank() == 0) {
+      std::cout << "Finished writing the LCP array" << std::endl;
+    }
+  }
+
+  if (check) {
+    std::vector<dsss::char_type> text = local_text();
 
     if (!output_path.empty()) {
       if (env.rank() == 0) {
         std::cout << "To check if export of the SA was successful, we first "
                   << "load the exported file ... ";
       }
-      sa = dsss::mpi::read_data<index_type>(output_path);
+      if (split_output) {
+        sa = dsss::mpi::read_split_data<index_type>(output_path);
+      } else if (packed_output) {
+        sa = dsss::mpi::read_packed_data<index_type>(output_path, io_hints);
+      } else {
+        sa = dsss::mpi::read_data<index_type>(output_path, io_hints);
+      }
       if (env.rank() == 0) {
         std::cout << "DONE" << std::endl;
       }
     }
     if (env.rank() == 0) { std::cout << "Checking SA ... "; }
-    bool correct = dsss::suffix_sorting::check(sa, distributed_strings.string);
+    bool correct = false;
+    if (check_sample_ratio > 0.0) {
+      correct = dsss::suffix_sorting::check_probabilistic(sa, text,
+        check_sample_ratio);
+    } else {
+      correct = dsss::suffix_sorting::check(sa, text);
+    }
     if (!correct && env.rank() == 0) {
       std::cout << "ERROR: Not a correct SA!" << std::endl;
     } else if (env.rank() == 0) {
       std::cout << "Correct SA!" << std::endl;
     }
   }
+}
+
+int32_t main(int32_t argc, char const *argv[]) {
+  dsss::mpi::environment env;
+  tlx::CmdlineParser cp;
+
+  cp.set_description("Distributed Suffix Array Construction");
+  cp.set_author("Florian Kurpicz <florian.kurpicz@tu-dortmund.de>");
+
+  cp.add_param_string("input", input_path,
+                      "Path to input file. The special input 'random' generates"
+                      " a random text of the size given by parameter '-s'.");
+
+  cp.add_bytes('s', "size", string_size, "Size (in bytes unless stated "
+               "otherwise) of the string that use to test our suffix array "
+               "construction algorithms.");
+
+  cp.add_bytes('H', "halo", halo_size, "Number of characters following "
+               "the local slice that each PE reads in addition, which saves "
+               "exchanging them with the neighbors (default: 256).");
+
+  cp.add_flag('M', "mmap", memory_map, "Map the input file into memory "
+              "instead of reading it. Prefix doubling ('-d') works on the "
+              "mapping directly, all other algorithms copy their slice. All "
+              "PEs have to be able to map the file (same node or shared file "
+              "system).");
+
+  cp.add_flag('c', "check", check, "Check if the SA has been constructed "
+              "correctly. This does not work with random text (no way to "
+              " reproduce).");
+
+  cp.add_double('p', "probabilistic", check_sample_ratio, "Check the SA "
+                "probabilistically using fingerprints, where the given ratio "
+                "of all adjacent suffixes is compared (implies '-c').");
+
+  cp.add_string('o', "output", "<F>", output_path, "Filename for the output "
+                "(SA). Note that each entry requires as many bytes as an index "
+                "(see '-w').");
+
+  cp.add_flag('k', "packed", packed_output, "Write the SA, ISA, and LCP array "
+              "bit-packed using ceil(log2(n)) bits per entry (instead of whole "
+              "indices), with a header describing the layout.");
+
+  cp.add_flag('f', "split", split_output, "Write the SA, ISA, LCP array, and "
+              "BWT as one file per PE (<F>.<rank>) and a manifest <F> "
+              "instead of one shared file.");
+
+  cp.add_string('l', "lcp", "<F>", lcp_output_path, "Filename for the LCP "
+                "array, which is computed from the SA if a filename is given. "
+                "It is written in the same format as the SA.");
+
+  cp.add_string('b', "bwt", "<F>", bwt_output_path, "Filename for the BWT, "
+                "which is computed from the SA if a filename is given. It is "
+                "written as a byte file of the same size as the input. The "
+                "primary index is written to <F>.primary.");
+
+  cp.add_string('i', "isa", "<F>", isa_output_path, "Filename for the "
+                "inverse suffix array, which is written in text order in the "
+                "same format as the SA.");
+
+  cp.add_flag('d', "discarding", doubling_discarding, "Compute the suffix array"
+              " using prefix doubling with discarding (instead of inducing).");
+
+  cp.add_flag('r', "recursive", recursive_bs_ranking, "Rank the B*-suffixes "
+              "by sorting the reduced string recursively instead of using "
+              "prefix doubling (inducing only).");
+
+  cp.add_size_t('L', "bs-length", max_bs_substring_length, "Sort "
+                "B*-substrings by pieces of at most this length, which helps "
+                "on repetitive texts (inducing only, default: no limit).");
+
+  cp.add_size_t('x', "dcx", dcx_size, "Compute the suffix array using the "
+                "difference cover algorithm DCX (instead of inducing). "
+                "Supported values for X are 3, 7, 13, and 21.");
+
+  cp.add_bytes('m', "memory", spill.memory_budget, "Memory budget (per PE) "
+               "for tuples that are discarded during prefix doubling. Tuples "
+               "exceeding the budget are spilled to the scratch directory.");
+
+  cp.add_string('t', "scratch", "<D>", spill.scratch_directory, "Directory "
+                "for spilled tuples, preferably on node-local storage "
+                "(default: current directory).");
+
+  cp.add_string('C', "checkpoint", "<D>", checkpoint.directory, "Directory "
+                "for checkpoints written during prefix doubling and inducing "
+                "(default: no checkpoints).");
+
+  cp.add_size_t('n', "checkpoint-interval", checkpoint.doubling_interval,
+                "Number of doubling iterations between two checkpoints "
+                "(default: 1).");
+
+  cp.add_flag('R', "resume", checkpoint.resume, "Resume the computation from "
+              "the checkpoints in the checkpoint directory (if any).");
+
+  cp.add_size_t('S', "stripe-count", io_hints.striping_factor, "Number of "
+                "storage targets the output files are striped across (MPI-IO "
+                "hint, default: file system default).");
+
+  cp.add_bytes('U', "stripe-size", io_hints.striping_unit, "Stripe size of "
+               "the output files (MPI-IO hint, default: file system "
+               "default).");
+
+  cp.add_size_t('A', "aggregators", io_hints.cb_nodes, "Number of "
+                "aggregators used for collective I/O (MPI-IO hint, default: "
+                "chosen by MPI).");
+
+  cp.add_bytes('B', "cb-buffer", io_hints.cb_buffer_size, "Buffer size of "
+               "each aggregator used for collective I/O (MPI-IO hint, "
+               "default: chosen by MPI).");
+
+  cp.add_size_t('w', "width", index_bits, "Number of bits per index (32, 40, "
+                "48, or 64). By default, the smallest width that can represent "
+                "all positions of the text is used.");
+
+  cp.add_size_t('T', "threads", threads, "Number of threads per PE used for "
+                "local sorting, merging, and classification (requires "
+                "OpenMP, default: OMP_NUM_THREADS or all cores).");
+
+  if (!cp.process(argc, argv)) {
+    return -1;
+  }
+#if defined(_OPENMP)
+  if (threads > 0) { omp_set_num_threads(threads); }
+#endif
+  check |= (check_sample_ratio > 0.0);
+
+  if (dcx_size > 0 && dcx_size != 3 && dcx_size != 7 && dcx_size != 13 &&
+      dcx_size != 21) {
+    if (env.rank() == 0) {
+      std::cerr << "DCX is only available for X in {3, 7, 13, 21}."
+                << std::endl;
+    }
+    return -1;
+  }
+
+  dsss::distributed_string distributed_strings;
+  dsss::distributed_string_view mapped_strings;
+
+  if (!input_path.compare("random")) {
+    memory_map = false;
+    string_size /= env.size();
+    dsss::random_indexed_string_set<size_t> rss(string_size, 255);
+    distributed_strings = { env.rank() * string_size,
+      std::move(rss.data_container()) };
+  } else if (memory_map) {
+    input_file = dsss::mapped_file(input_path);
+    mapped_strings = dsss::mpi::map_string(input_file, string_size,
+      halo_size);
+  } else {
+    distributed_strings = dsss::mpi::distribute_string(input_path,
+      string_size, halo_size);
+  }
+
+  // The smallest index type that can represent all positions of the text is
+  // used, as the size of the indices determines the communication volume.
+  size_t local_size = memory_map ? mapped_strings.string.size() :
+    distributed_strings.string.size();
+  const size_t total_size = dsss::mpi::allreduce_sum(local_size, env);
+  size_t required_bits = 64;
+  if (total_size < std::numeric_limits<std::uint32_t>::max()) {
+    required_bits = 32;
+  } else if (total_size < (std::uint64_t(1) << 40) - 1) {
+    required_bits = 40;
+  } else if (total_size < (std::uint64_t(1) << 48) - 1) {
+    required_bits = 48;
+  }
+  if (index_bits == 0) {
+    index_bits = required_bits;
+  } else if (index_bits < required_bits || (index_bits != 32 &&
+             index_bits != 40 && index_bits != 48 && index_bits != 64)) {
+    if (env.rank() == 0) {
+      std::cerr << "The text requires indices of at least " << required_bits
+                << " bits. Supported widths are 32, 40, 48, and 64 bits."
+                << std::endl;
+    }
+    return -1;
+  }
+
+  if (env.rank() == 0) {
+    std::cout << "Using " << index_bits << "-bit indices" << std::endl;
+  }
+  auto compute = [&](auto&& text) {
+    if (index_bits == 32) {
+      compute_suffix_array<std::uint32_t>(std::move(text), env);
+    } else if (index_bits == 40) {
+      compute_suffix_array<dsss::uint40>(std::move(text), env);
+    } else if (index_bits == 48) {
+      compute_suffix_array<dsss::uint48>(std::move(text), env);
+    } else {
+      compute_suffix_array<std::uint64_t>(std::move(text), env);
+    }
+  };
+  if (memory_map) {
+    compute(mapped_strings);
+  } else {
+    compute(distributed_strings);
+  }
 
   env.finalize();
   return 0;
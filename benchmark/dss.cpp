@@ -8,10 +8,15 @@
 
 #include <tlx/cmdline_parser.hpp>
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <random>
 
+#include "mpi/allgather.hpp"
 #include "mpi/allreduce.hpp"
+#include "mpi/broadcast.hpp"
 #include "mpi/distribute_input.hpp"
 #include "mpi/environment.hpp"
 #include "mpi/shift.hpp"
@@ -19,12 +24,35 @@
 #include "string_sorting/util/algorithm.hpp"
 #include "string_sorting/distributed/merge_sort.hpp"
 #include "suffix_sorting/classification.hpp"
+#include "util/fingerprint.hpp"
 
 std::size_t string_size;
 std::string input_path;
 bool b_star_substrings;
 bool check;
 bool export_times;
+std::string output_path;
+bool split_output;
+
+// Computes the multiset hash of the strings of all PEs. The base and z are
+// chosen at random (using the seed, which has to be the same on all PEs).
+std::uint64_t global_multiset_hash(dsss::string_set& strings,
+  const std::uint64_t seed, dsss::mpi::environment env) {
+
+  std::mt19937_64 rand_gen(seed);
+  const std::uint64_t z = rand_gen() % dsss::mersenne_61::prime;
+  const std::uint64_t base =
+    256 + (rand_gen() % (dsss::mersenne_61::prime - 256));
+  dsss::string_multiset_hash hash(base, z);
+  for (std::size_t i = 0; i < strings.size(); ++i) {
+    hash.add(strings[i]);
+  }
+  std::uint64_t local_hash = hash.value();
+  auto hashes = dsss::mpi::allgather(local_hash, env);
+  dsss::string_multiset_hash global_hash(base, z);
+  for (const auto& h : hashes) { global_hash.combine(h); }
+  return global_hash.value();
+}
 
 std::int32_t main(std::int32_t argc, char const *argv[]) {
   dsss::mpi::environment env;
@@ -47,7 +75,14 @@ std::int32_t main(std::int32_t argc, char const *argv[]) {
     "otherwise) of the string that use to test our string sorting algorithms.");
 
   cp.add_flag('c', "check", check, "Check if the substrings have been sorted "
-    "correctly.");
+    "correctly, i.e., they are sorted and (with high probability) the same "
+    "multiset of strings as before the sorting.");
+
+  cp.add_string('o', "output", "<F>", output_path, "Filename for the sorted "
+    "strings (zero-terminated, in sorted order).");
+
+  cp.add_flag('f', "split", split_output, "Write the sorted strings as one "
+    "file per PE (<F>.<rank>) and a manifest <F> instead of one shared file.");
 
   if (!cp.process(argc, argv)) {
     return -1;
@@ -67,7 +102,8 @@ std::int32_t main(std::int32_t argc, char const *argv[]) {
       dsss::string_set strings_to_sort;
       if (b_star_substrings) {
         auto distributed_strings =
-          dsss::mpi::distribute_string(input_path, string_size);
+          dsss::mpi::distribute_string(input_path, string_size,
+            dsss::mpi::default_halo_size);
         std::tie(strings_to_sort, std::ignore) = dsss::suffix_sorting::
           b_star_substrings<std::size_t>(distributed_strings);
       } else {
@@ -80,6 +116,19 @@ std::int32_t main(std::int32_t argc, char const *argv[]) {
       std::size_t local_size = strings_to_sort.size();
       std::size_t local_length = strings_to_sort.data_container().size();
 
+      // The multiset hash of the strings before the sorting is computed using
+      // the same random base and z as the one after the sorting.
+      std::uint64_t seed = 0;
+      std::uint64_t initial_hash = 0;
+      if (check) {
+        if (env.rank() == 0) {
+          std::random_device rand_seed;
+          seed = (std::uint64_t(rand_seed()) << 32) | rand_seed();
+        }
+        seed = dsss::mpi::broadcast(seed, 0, env);
+        initial_hash = global_multiset_hash(strings_to_sort, seed, env);
+      }
+
       env.barrier();
       auto start_time = MPI_Wtime();
       algorithm->run(strings_to_sort);
@@ -89,6 +138,20 @@ std::int32_t main(std::int32_t argc, char const *argv[]) {
                   << std::endl;
       }
       env.barrier();
+      if (!output_path.empty()) {
+        std::vector<dsss::char_type> sorted_chars;
+        sorted_chars.reserve(strings_to_sort.data_container().size());
+        for (std::size_t i = 0; i < strings_to_sort.size(); ++i) {
+          const std::size_t length = dsss::string_length(strings_to_sort[i]);
+          std::copy_n(strings_to_sort[i], length + 1,
+                      std::back_inserter(sorted_chars));
+        }
+        if (split_output) {
+          dsss::mpi::write_split_data(sorted_chars, output_path);
+        } else {
+          dsss::mpi::write_data(sorted_chars, output_path);
+        }
+      }
       if (check) {
         if (env.rank() == 0) {
           std::cout << "Checking correctness ... ";
@@ -128,11 +191,19 @@ std::int32_t main(std::int32_t argc, char const *argv[]) {
         local_length = strings_to_sort.data_container().size();
         std::size_t new_global_size = dsss::mpi::allreduce_sum(local_size);
         std::size_t new_global_length = dsss::mpi::allreduce_sum(local_length);
+        const std::uint64_t new_hash =
+          global_multiset_hash(strings_to_sort, seed, env);
 
         if (env.rank() == 0) {
           if (initial_global_size == new_global_size &&
             initial_global_length == new_global_length) {
-            std::cout << "everything OK!" << std::endl;
+            if (initial_hash == new_hash) {
+              std::cout << "everything OK!" << std::endl;
+            } else {
+              std::cout << "ERROR: some strings have been changed during the "
+                        << "sorting." << std::endl;
+              std::exit(-1);
+            }
           } else if (initial_global_length < new_global_length) {
             std::cout << "ERROR: some characters appeared out of nowhere."
                       << std::endl;
@@ -42,7 +42,7 @@ static inline std::vector<DataType> allgatherv_small(
   std::vector<DataType>& send_data, environment env = environment()) {
 
   int32_t local_size = send_data.size();
-  std::vector<int32_t> receiving_sizes = allgather(local_size);
+  std::vector<int32_t> receiving_sizes = allgather(local_size, env);
 
   std::vector<int32_t> receiving_offsets(env.size(), 0);
   for (size_t i = 1; i < receiving_sizes.size(); ++i) {
@@ -71,7 +71,7 @@ static inline std::vector<DataType> allgatherv(
   std::vector<DataType>& send_data, environment env = environment()) {
 
   size_t local_size = send_data.size();
-  std::vector<size_t> receiving_sizes = allgather(local_size);
+  std::vector<size_t> receiving_sizes = allgather(local_size, env);
 
   std::vector<size_t> receiving_offsets(env.size(), 0);
   for (size_t i = 1; i < receiving_sizes.size(); ++i) {
@@ -79,7 +79,7 @@ static inline std::vector<DataType> allgatherv(
   }
 
   if (receiving_sizes.back() + receiving_offsets.back() < env.mpi_max_int()) {
-    return allgatherv_small(send_data);
+    return allgatherv_small(send_data, env);
   } else {
     std::vector<MPI_Request> mpi_requests(2 * env.size());
     std::vector<DataType> receiving_data(
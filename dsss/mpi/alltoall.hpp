@@ -21,6 +21,7 @@
 #include "mpi/type_mapper.hpp"
 #include "mpi/scan.hpp"
 #include "util/indexed_string_set.hpp"
+#include "util/indexed_substring_set.hpp"
 #include "util/string.hpp"
 #include "util/string_set.hpp"
 
@@ -219,9 +220,12 @@ inline std::vector<dsss::char_type> alltoallv_strings(
   return alltoallv(send_buffer, send_counts_char, env);
 }
 
-template <typename IndexType>
+// The strings can either be an indexed_string_set or an indexed_substring_set.
+// In both cases, the received strings are 0-terminated.
+template <typename StringSet,
+          typename IndexType = typename StringSet::index_type>
 inline dsss::indexed_string_set<IndexType> alltoallv_indexed_strings(
-  dsss::indexed_string_set<IndexType>& send_data,
+  StringSet& send_data,
   std::vector<size_t>& send_counts_strings,
   environment const& env = environment()) {
 
@@ -236,12 +240,14 @@ inline dsss::indexed_string_set<IndexType> alltoallv_indexed_strings(
   for (size_t scs_pos = 0, string_pos = 0; scs_pos < size; ++scs_pos) {
     for (size_t i = 0; i < send_counts_strings[scs_pos]; ++i) {
       index_send_data.emplace_back(send_data[string_pos].index);
-      // The "+1" is there to also send the terminating 0
+      // The "+1" is there to also send the terminating 0, which is appended
+      // explicitly, as substrings are not 0-terminated
       const size_t string_length =
-        dsss::string_length(send_data[string_pos].string) + 1;
-      send_counts_char[scs_pos] += string_length;
+        dsss::string_length(send_data[string_pos]);
+      send_counts_char[scs_pos] += string_length + 1;
       std::copy_n(send_data[string_pos].string, string_length,
         std::back_inserter(real_send_data));
+      real_send_data.emplace_back(dsss::char_type(0));
       ++string_pos;
     }
   }
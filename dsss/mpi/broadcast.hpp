@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "mpi/environment.hpp"
 #include "mpi/type_mapper.hpp"
 
@@ -29,19 +32,18 @@ inline DataType broadcast(DataType send_data, int32_t const root,
 
 inline std::string broadcast(std::string& send_data, int32_t const root,
                              environment env = environment()) {
- 
-  auto result = send_data;
-  int32_t size = broadcast(result.size(), root);
+
+  size_t size = broadcast(send_data.size(), root, env);
+  std::vector<char> buffer(send_data.begin(), send_data.end());
+  buffer.resize(size);
 
   data_type_mapper<char> dtm;
-  std::vector<char> buffer(size);
-  MPI_Bcast(result.data(),
+  MPI_Bcast(buffer.data(),
             size,
             dtm.get_mpi_type(),
             root,
             env.communicator());
-  result = std::string(buffer.data(), size);
-  return result;
+  return std::string(buffer.data(), size);
 }
 
 } // namespace dsss::mpi
@@ -0,0 +1,208 @@
+/*******************************************************************************
+ * mpi/checkpoint.hpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <mpi.h>
+#include <string>
+#include <vector>
+
+#include "mpi/allgather.hpp"
+#include "mpi/environment.hpp"
+#include "mpi/file_io.hpp"
+
+namespace dsss::mpi {
+
+// Checkpoints are disabled if no directory is given. Prefix doubling writes a
+// checkpoint after every doubling_interval iterations.
+struct checkpoint_config {
+  std::string directory = "";
+  size_t doubling_interval = 1;
+  bool resume = false;
+
+  bool enabled() const {
+    return !directory.empty();
+  }
+
+  std::string path(const std::string& name) const {
+    return directory + "/" + name + ".ckpt";
+  }
+}; // struct checkpoint_config
+
+// A checkpoint consists of a tag (e.g., the current iteration) and a sequence
+// of distributed vectors, which are written using collective MPI-IO. For each
+// vector, the sizes of all local blocks are stored, followed by the blocks in
+// rank order. The checkpoint is written to a temporary file, which is renamed
+// when the writer is closed. Hence, a checkpoint is either complete or missing.
+class checkpoint_writer {
+
+public:
+  checkpoint_writer(const std::string& file_name, const std::uint64_t tag,
+                    environment env = environment())
+    : file_name_(file_name), env_(env) {
+
+    const std::string tmp_name = file_name_ + ".tmp";
+    MPI_File_open(env_.communicator(),
+                  const_cast<char*>(tmp_name.c_str()),
+                  MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL,
+                  &mpi_file_);
+    MPI_File_set_size(mpi_file_, 0);
+    if (env_.rank() == 0) {
+      std::uint64_t header[3] = { magic, tag, std::uint64_t(env_.size()) };
+      MPI_File_write_at(mpi_file_,
+                        0,
+                        header,
+                        3 * sizeof(std::uint64_t),
+                        MPI_BYTE,
+                        MPI_STATUS_IGNORE);
+    }
+    offset_ = 3 * sizeof(std::uint64_t);
+  }
+
+  checkpoint_writer(const checkpoint_writer&) = delete;
+  checkpoint_writer& operator =(const checkpoint_writer&) = delete;
+
+  ~checkpoint_writer() {
+    close();
+  }
+
+  template <typename DataType>
+  void write(std::vector<DataType>& local_data) {
+    std::uint64_t local_bytes = local_data.size() * sizeof(DataType);
+    std::vector<std::uint64_t> all_bytes = allgather(local_bytes, env_);
+
+    if (env_.rank() == 0) {
+      MPI_File_write_at(mpi_file_,
+                        offset_,
+                        all_bytes.data(),
+                        all_bytes.size() * sizeof(std::uint64_t),
+                        MPI_BYTE,
+                        MPI_STATUS_IGNORE);
+    }
+    offset_ += all_bytes.size() * sizeof(std::uint64_t);
+    MPI_Offset local_offset = offset_;
+    for (int32_t rank = 0; rank < env_.size(); ++rank) {
+      if (rank < env_.rank()) { local_offset += all_bytes[rank]; }
+      offset_ += all_bytes[rank];
+    }
+    write_at_all(mpi_file_, local_offset, local_data.data(), local_bytes,
+                 env_);
+  }
+
+  void close() {
+    if (closed_) { return; }
+    MPI_File_close(&mpi_file_);
+    env_.barrier();
+    if (env_.rank() == 0) {
+      std::rename((file_name_ + ".tmp").c_str(), file_name_.c_str());
+    }
+    env_.barrier();
+    closed_ = true;
+  }
+
+  static constexpr std::uint64_t magic = 0x544e494f504b4343ULL;
+
+private:
+  std::string file_name_;
+  environment env_;
+  MPI_File mpi_file_;
+  MPI_Offset offset_;
+  bool closed_ = false;
+
+}; // class checkpoint_writer
+
+// Reads a checkpoint written by checkpoint_writer. The vectors have to be
+// read in the same order (and with the same types) as they have been written.
+// A checkpoint can only be read by the same number of PEs that has written it.
+class checkpoint_reader {
+
+public:
+  checkpoint_reader(const std::string& file_name,
+                    environment env = environment()) : env_(env) {
+
+    valid_ = (MPI_File_open(env_.communicator(),
+                            const_cast<char*>(file_name.c_str()),
+                            MPI_MODE_RDONLY,
+                            MPI_INFO_NULL,
+                            &mpi_file_) == MPI_SUCCESS);
+    if (valid_) {
+      std::uint64_t header[3] = { 0, 0, 0 };
+      MPI_File_read_at(mpi_file_,
+                       0,
+                       header,
+                       3 * sizeof(std::uint64_t),
+                       MPI_BYTE,
+                       MPI_STATUS_IGNORE);
+      tag_ = header[1];
+      if (header[0] != checkpoint_writer::magic ||
+          header[2] != std::uint64_t(env_.size())) {
+        MPI_File_close(&mpi_file_);
+        valid_ = false;
+      }
+    }
+    offset_ = 3 * sizeof(std::uint64_t);
+  }
+
+  checkpoint_reader(const checkpoint_reader&) = delete;
+  checkpoint_reader& operator =(const checkpoint_reader&) = delete;
+
+  ~checkpoint_reader() {
+    if (valid_) { MPI_File_close(&mpi_file_); }
+  }
+
+  inline bool valid() const {
+    return valid_;
+  }
+
+  inline std::uint64_t tag() const {
+    return tag_;
+  }
+
+  template <typename DataType>
+  std::vector<DataType> read() {
+    std::vector<std::uint64_t> all_bytes(env_.size());
+    MPI_File_read_at(mpi_file_,
+                     offset_,
+                     all_bytes.data(),
+                     all_bytes.size() * sizeof(std::uint64_t),
+                     MPI_BYTE,
+                     MPI_STATUS_IGNORE);
+    offset_ += all_bytes.size() * sizeof(std::uint64_t);
+    MPI_Offset local_offset = offset_;
+    for (int32_t rank = 0; rank < env_.size(); ++rank) {
+      if (rank < env_.rank()) { local_offset += all_bytes[rank]; }
+      offset_ += all_bytes[rank];
+    }
+    std::vector<DataType> result(all_bytes[env_.rank()] / sizeof(DataType));
+    read_at_all(mpi_file_, local_offset, result.data(),
+                all_bytes[env_.rank()], env_);
+    return result;
+  }
+
+private:
+  environment env_;
+  MPI_File mpi_file_;
+  MPI_Offset offset_;
+  bool valid_ = false;
+  std::uint64_t tag_ = 0;
+
+}; // class checkpoint_reader
+
+static inline void remove_checkpoint(const std::string& file_name,
+  environment env = environment()) {
+  env.barrier();
+  if (env.rank() == 0) {
+    std::remove(file_name.c_str());
+  }
+}
+
+} // namespace dsss::mpi
+
+/******************************************************************************/
@@ -10,24 +10,59 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
 #include <mpi.h>
+#include <numeric>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <tlx/digest/sha1.hpp>
 
+#include "mpi/allgather.hpp"
 #include "mpi/broadcast.hpp"
 #include "mpi/environment.hpp"
+#include "mpi/file_io.hpp"
 #include "mpi/scan.hpp"
 #include "mpi/shift.hpp"
 #include "mpi/type_mapper.hpp"
+#include "util/mapped_file.hpp"
 #include "util/string.hpp"
 #include "util/string_set.hpp"
 
 namespace dsss::mpi {
 
+// Halo that suffices for packing characters into 64-bit ranks during prefix
+// doubling and for most leftmost B*-substrings.
+static constexpr size_t default_halo_size = 256;
+
+// Returns the offset and the size of the local slice of a text that is
+// distributed evenly, i.e., the first (size % p) PEs get one more character.
+static std::pair<size_t, size_t> text_slice(const size_t global_size,
+  environment env = environment()) {
+
+  size_t local_slice_size = global_size / env.size();
+  int64_t larger_slices = global_size % env.size();
+
+  size_t offset;
+  if (env.rank() < larger_slices) {
+    ++local_slice_size;
+    offset = local_slice_size * env.rank();
+  } else {
+    offset = larger_slices * (local_slice_size + 1);
+    offset += (env.rank() - larger_slices) * local_slice_size;
+  }
+  return std::make_pair(offset, local_slice_size);
+}
+
+// Reads the local slice of the text and the halo_size characters following
+// it (see distributed_string) using one read per PE. The slices overlap in the
+// file, hence, no characters have to be exchanged between neighbors.
 static dsss::distributed_string distribute_string(
-  const std::string& input_path, size_t max_size = 0,
+  const std::string& input_path, size_t max_size, size_t halo_size,
   environment env = environment()) {
 
   MPI_File mpi_file;
@@ -46,33 +81,79 @@ static dsss::distributed_string distribute_string(
       std::min(max_size, static_cast<size_t>(global_file_size));
   }
 
-  size_t local_slice_size = global_file_size / env.size();
-  int64_t larger_slices = global_file_size % env.size();
+  auto [ offset, local_slice_size ] = text_slice(global_file_size, env);
 
-  size_t offset;
-  if (env.rank() < larger_slices) {
-    ++local_slice_size;
-    offset = local_slice_size * env.rank();
-  } else {
-    offset = larger_slices * (local_slice_size + 1);
-    offset += (env.rank() - larger_slices) * local_slice_size;
+  const size_t read_size = std::min(local_slice_size + halo_size,
+    static_cast<size_t>(global_file_size) - offset);
+  std::vector<dsss::char_type> result(read_size);
+  read_at_all(mpi_file, offset, result.data(), read_size, env);
+  MPI_File_close(&mpi_file);
+
+  std::vector<dsss::char_type> halo(result.begin() + local_slice_size,
+    result.end());
+  halo.resize(halo_size, dsss::char_type(0));
+  result.resize(local_slice_size);
+
+  return dsss::distributed_string { offset, result, halo };
+}
+
+static dsss::distributed_string distribute_string(
+  const std::string& input_path, size_t max_size = 0,
+  environment env = environment()) {
+
+  return distribute_string(input_path, max_size, 0, env);
+}
+
+// Like distribute_string, but the slice is a view of the memory-mapped file
+// instead of a copy. All PEs have to be able to map the file, e.g., because
+// they run on the same node or use a shared file system. The view is valid as
+// long as the mapping exists.
+static dsss::distributed_string_view map_string(
+  const dsss::mapped_file& file, size_t max_size = 0, size_t halo_size = 0,
+  environment env = environment()) {
+
+  size_t global_file_size = file.size();
+  if (max_size > 0) {
+    global_file_size = std::min(max_size, global_file_size);
   }
+  auto [ offset, local_slice_size ] = text_slice(global_file_size, env);
 
-  MPI_File_seek(
-    mpi_file,
-    offset,
-    MPI_SEEK_SET);
+  const dsss::char_type* slice = file.data() + offset;
+  const size_t halo_end = std::min(offset + local_slice_size + halo_size,
+    global_file_size);
+  std::vector<dsss::char_type> halo(slice + local_slice_size,
+    file.data() + halo_end);
+  halo.resize(halo_size, dsss::char_type(0));
 
-  std::vector<dsss::char_type> result(local_slice_size);
+  return dsss::distributed_string_view {
+    offset, { slice, local_slice_size }, halo };
+}
 
-  MPI_File_read(
-    mpi_file,
-    result.data(),
-    local_slice_size,
-    type_mapper<dsss::char_type>::type(),
-    MPI_STATUS_IGNORE);
+// Moves the characters of strings that span multiple PEs to the PE where the
+// string starts, such that each PE contains only complete strings.
+static void align_strings(std::vector<dsss::char_type>& local_chars,
+  environment env = environment()) {
 
-  return dsss::distributed_string { offset, result };
+  size_t first_end = 0;
+  while (first_end < local_chars.size() && local_chars[first_end] != 0) {
+    ++first_end;
+  }
+
+  std::vector<dsss::char_type> end_of_last_string = dsss::mpi::shift_left(
+    local_chars.data(), first_end + 1, env);
+  // We copy this string, even if it's not the end of the last one on the
+  // previous PE, but a new string. This way, we can delete it on the sending
+  // PE without checking if it was the end.
+  if (env.rank() + 1 < env.size()) {
+    std::copy_n(end_of_last_string.begin(), end_of_last_string.size(),
+      std::back_inserter(local_chars));
+  } else if (local_chars.empty() || local_chars.back() != 0) {
+    local_chars.emplace_back(0); // Make last string end
+  }
+  if (env.rank() > 0) { // Delete the sent string
+    local_chars.erase(local_chars.begin(),
+      local_chars.begin() + std::min(first_end + 1, local_chars.size()));
+  }
 }
 
 dsss::distributed_string distribute_strings(
@@ -121,59 +202,34 @@ dsss::distributed_string distribute_strings(
     type_mapper<dsss::char_type>::type(),
     MPI_STATUS_IGNORE);
 
-  size_t first_end = 0;
-  while (first_end < result.size() && result[first_end] != 0) { ++first_end; }
-
-  std::vector<dsss::char_type> end_of_last_string = dsss::mpi::shift_left(
-    result.data(), first_end + 1);
-  // We copy this string, even if it's not the end of the last one on the
-  // previous PE, but a new string. This way, we can delete it on the sending
-  // PE without checking if it was the end.
-  if (env.rank() + 1 < env.size()) {
-    std::copy_n(end_of_last_string.begin(), end_of_last_string.size(),
-      std::back_inserter(result));
-  } else {
-    if (result.back() != 0) { result.emplace_back(0); } // Make last string end
-  }
-  if (env.rank() > 0) { // Delete the sent string
-    result.erase(result.begin(), result.begin() + first_end + 1);
-  }
-
+  align_strings(result, env);
   return dsss::distributed_string { offset, result };
 }
 
+// Writes the distributed data to one file, in the order of the PEs. The
+// offset of each PE is computed using a prefix sum, such that all PEs can write
+// their data with one collective call.
 template <typename DataType>
 static void write_data(std::vector<DataType>& local_data,
-  const std::string file_name, environment env = environment()) {
-
-  MPI_File mpi_file;
+  const std::string file_name, const io_hints& hints = io_hints(),
+  environment env = environment()) {
 
-  MPI_File_open(env.communicator(),
-                const_cast<char*>(file_name.c_str()),
-                MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL,
-                &mpi_file);
+  MPI_File mpi_file = open_file(file_name, MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                                hints, env);
+  MPI_File_set_size(mpi_file, 0);
 
-  MPI_File_write_ordered(mpi_file,
-                         local_data.data(),
-                         local_data.size() * sizeof(DataType),
-                         MPI_BYTE,
-                         MPI_STATUS_IGNORE);
+  size_t local_bytes = local_data.size() * sizeof(DataType);
+  const size_t offset = dsss::mpi::ex_prefix_sum(local_bytes, env);
+  write_at_all(mpi_file, offset, local_data.data(), local_bytes, env);
 
   MPI_File_close(&mpi_file);
 }
 
 template <typename DataType>
 static std::vector<DataType> read_data(const std::string file_name,
-  environment env = environment()) {
+  const io_hints& hints = io_hints(), environment env = environment()) {
 
-  MPI_File mpi_file;
-
-  MPI_File_open(
-    env.communicator(),
-    const_cast<char*>(file_name.c_str()),
-    MPI_MODE_RDONLY,
-    MPI_INFO_NULL,
-    &mpi_file);
+  MPI_File mpi_file = open_file(file_name, MPI_MODE_RDONLY, hints, env);
 
   MPI_Offset global_file_size = 0;
   MPI_File_get_size(mpi_file, &global_file_size);
@@ -191,23 +247,190 @@ static std::vector<DataType> read_data(const std::string file_name,
     offset += (env.rank() - larger_slices) * local_slice_size;
   }
 
-  MPI_File_seek(
-    mpi_file,
-    offset * sizeof(DataType),
-    MPI_SEEK_SET);
-
   std::vector<DataType> result(local_slice_size);
+  read_at_all(mpi_file, offset * sizeof(DataType), result.data(),
+              local_slice_size * sizeof(DataType), env);
 
-  MPI_File_read(
-    mpi_file,
-    result.data(),
-    local_slice_size * sizeof(DataType),
-    MPI_BYTE,
-    MPI_STATUS_IGNORE);
+  MPI_File_close(&mpi_file);
+  return result;
+}
+
+// In the split format, each PE writes its local data to its own file
+// <file_name>.<rank> (without MPI-IO, hence without locking a shared file).
+// Each file starts with a header of 64-bit words: the magic number, the global
+// index of the first entry, the number of bytes per entry, and the number of
+// entries. Additionally, PE 0 writes the manifest <file_name>, a small text
+// file containing the number of files, the number of bytes per entry, the
+// total number of entries, and the global index of the first entry of each
+// file.
+struct split_manifest {
+  static constexpr std::uint64_t magic = 0x54494c5053535344ULL;
+  static constexpr size_t header_bytes = 4 * sizeof(std::uint64_t);
+
+  std::uint64_t width = 0;
+  std::uint64_t size = 0;
+  std::vector<std::uint64_t> offsets;
+
+  size_t files() const {
+    return offsets.size();
+  }
+
+  std::uint64_t file_size(const size_t file) const {
+    return ((file + 1 < offsets.size()) ? offsets[file + 1] : size) -
+      offsets[file];
+  }
+
+  static std::string file_name(const std::string& name, const size_t rank) {
+    return name + "." + std::to_string(rank);
+  }
+}; // struct split_manifest
+
+template <typename DataType>
+static void write_split_data(std::vector<DataType>& local_data,
+  const std::string file_name, environment env = environment()) {
+
+  size_t local_size = local_data.size();
+  const std::uint64_t offset = dsss::mpi::ex_prefix_sum(local_size, env);
+  const std::uint64_t header[4] = { split_manifest::magic, offset,
+    sizeof(DataType), local_size };
+
+  std::ofstream file(split_manifest::file_name(file_name, env.rank()),
+                     std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(local_data.data()),
+             local_size * sizeof(DataType));
+  file.close();
+
+  std::vector<size_t> sizes = dsss::mpi::allgather(local_size, env);
+  if (env.rank() == 0) {
+    std::ofstream manifest(file_name, std::ios::trunc);
+    manifest << "dsss-split " << env.size() << ' ' << sizeof(DataType) << ' '
+             << std::accumulate(sizes.begin(), sizes.end(), size_t(0))
+             << std::endl;
+    for (size_t rank = 0, offset = 0; rank < sizes.size(); ++rank) {
+      manifest << offset << std::endl;
+      offset += sizes[rank];
+    }
+  }
+  env.barrier();
+}
+
+// Reads the manifest on PE 0 and broadcasts it. Returns an empty manifest (no
+// files) if the file is not a manifest of split data.
+static split_manifest read_split_manifest(const std::string file_name,
+  environment env = environment()) {
+
+  std::string content;
+  if (env.rank() == 0) {
+    std::ifstream manifest(file_name);
+    std::stringstream buffer;
+    buffer << manifest.rdbuf();
+    content = buffer.str();
+  }
+  content = dsss::mpi::broadcast(content, 0, env);
+
+  split_manifest result;
+  std::istringstream stream(content);
+  std::string format;
+  size_t files = 0;
+  if (!(stream >> format >> files >> result.width >> result.size) ||
+      format != "dsss-split") {
+    return split_manifest();
+  }
+  result.offsets.resize(files);
+  for (auto& offset : result.offsets) { stream >> offset; }
+  return result;
+}
+
+// Reports that the split data cannot be read and aborts the program.
+[[noreturn]] static void split_data_error(const std::string& file_name,
+  const std::string& message) {
+  std::cerr << "Cannot read split data " << file_name << ": " << message
+            << std::endl;
+  std::abort();
+}
 
+// Reads data written by write_split_data. If the number of PEs is the same as
+// the number of files, each PE reads its own file, i.e., the data has the same
+// distribution as when it was written. Otherwise, the data is distributed the
+// same way as by read_data. A missing manifest, entries of another width, and
+// files whose headers do not match the manifest are reported and abort the
+// program.
+template <typename DataType>
+static std::vector<DataType> read_split_data(const std::string file_name,
+  environment env = environment()) {
+
+  split_manifest manifest = read_split_manifest(file_name, env);
+  std::vector<DataType> result;
+  if (manifest.files() == 0) {
+    split_data_error(file_name, "not a manifest of split data");
+  }
+  if (manifest.width != sizeof(DataType)) {
+    split_data_error(file_name, "entries have " +
+      std::to_string(manifest.width) + " bytes instead of " +
+      std::to_string(sizeof(DataType)));
+  }
+
+  size_t begin = 0;
+  size_t end = 0;
+  if (manifest.files() == size_t(env.size())) {
+    begin = manifest.offsets[env.rank()];
+    end = begin + manifest.file_size(env.rank());
+  } else {
+    size_t local_slice_size = manifest.size / env.size();
+    int64_t larger_slices = manifest.size % env.size();
+    if (env.rank() < larger_slices) {
+      ++local_slice_size;
+      begin = local_slice_size * env.rank();
+    } else {
+      begin = larger_slices * (local_slice_size + 1);
+      begin += (env.rank() - larger_slices) * local_slice_size;
+    }
+    end = begin + local_slice_size;
+  }
+
+  result.resize(end - begin);
+  for (size_t file = 0; file < manifest.files(); ++file) {
+    const size_t file_begin = manifest.offsets[file];
+    const size_t file_end = file_begin + manifest.file_size(file);
+    if (file_end <= begin || file_begin >= end) { continue; }
+
+    const size_t first = std::max(begin, file_begin);
+    const size_t last = std::min(end, file_end);
+    const std::string part_name = split_manifest::file_name(file_name, file);
+    std::ifstream stream(part_name, std::ios::binary);
+    std::uint64_t header[4];
+    stream.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!stream || header[0] != split_manifest::magic ||
+        header[1] != file_begin || header[2] != sizeof(DataType) ||
+        header[3] != file_end - file_begin) {
+      split_data_error(part_name, "header does not match the manifest");
+    }
+    stream.seekg(split_manifest::header_bytes +
+                 (first - file_begin) * sizeof(DataType));
+    stream.read(reinterpret_cast<char*>(result.data() + (first - begin)),
+                (last - first) * sizeof(DataType));
+    if (!stream) { split_data_error(part_name, "file is truncated"); }
+  }
   return result;
 }
 
+// Reads strings written by write_split_data (as zero-terminated characters).
+// If the number of PEs differs from the number of files, strings spanning
+// multiple PEs are moved to the PE where they start.
+static dsss::distributed_string read_split_strings(
+  const std::string file_name, environment env = environment()) {
+
+  split_manifest manifest = read_split_manifest(file_name, env);
+  auto result = read_split_data<dsss::char_type>(file_name, env);
+  if (manifest.files() != size_t(env.size())) {
+    align_strings(result, env);
+  }
+  size_t local_size = result.size();
+  const size_t offset = dsss::mpi::ex_prefix_sum(local_size, env);
+  return dsss::distributed_string { offset, result };
+}
+
 } // namespace dsss::mpi
 
 /******************************************************************************/
@@ -0,0 +1,121 @@
+/*******************************************************************************
+ * mpi/file_io.hpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <mpi.h>
+#include <string>
+
+#include "mpi/allreduce.hpp"
+#include "mpi/environment.hpp"
+
+namespace dsss::mpi {
+
+// Hints passed to MPI-IO when a file is opened. A value of 0 leaves the choice
+// to the MPI implementation (and the file system). Striping hints only take
+// effect when a file is created, e.g., on Lustre.
+struct io_hints {
+  // Number of storage targets a new file is striped across
+  size_t striping_factor = 0;
+  // Size (in bytes) of one stripe
+  size_t striping_unit = 0;
+  // Number of aggregators used for collective buffering
+  size_t cb_nodes = 0;
+  // Size (in bytes) of the buffer of each aggregator
+  size_t cb_buffer_size = 0;
+  bool collective_buffering = true;
+
+  // The returned info object has to be freed using MPI_Info_free.
+  MPI_Info create_info() const {
+    MPI_Info info;
+    MPI_Info_create(&info);
+    auto set = [&info](const std::string& key, const std::string& value) {
+      MPI_Info_set(info, const_cast<char*>(key.c_str()),
+                   const_cast<char*>(value.c_str()));
+    };
+    if (striping_factor > 0) {
+      set("striping_factor", std::to_string(striping_factor));
+    }
+    if (striping_unit > 0) {
+      set("striping_unit", std::to_string(striping_unit));
+    }
+    if (cb_nodes > 0) { set("cb_nodes", std::to_string(cb_nodes)); }
+    if (cb_buffer_size > 0) {
+      set("cb_buffer_size", std::to_string(cb_buffer_size));
+    }
+    const std::string cb = collective_buffering ? "enable" : "disable";
+    set("romio_cb_write", cb);
+    set("romio_cb_read", cb);
+    return info;
+  }
+}; // struct io_hints
+
+static inline MPI_File open_file(const std::string& file_name,
+  const int32_t mode, const io_hints& hints = io_hints(),
+  environment env = environment()) {
+
+  MPI_Info info = hints.create_info();
+  MPI_File mpi_file;
+  MPI_File_open(env.communicator(),
+                const_cast<char*>(file_name.c_str()),
+                mode,
+                info,
+                &mpi_file);
+  MPI_Info_free(&info);
+  return mpi_file;
+}
+
+// Collective MPI-IO calls only support int counts. Larger blocks are written
+// (read) in multiple rounds, in which all PEs participate.
+static inline void write_at_all(MPI_File& mpi_file, MPI_Offset offset,
+  const void* data, size_t bytes, environment env = environment()) {
+
+  const size_t max_bytes = env.mpi_max_int();
+  size_t rounds = (bytes + max_bytes - 1) / max_bytes;
+  rounds = std::max(size_t(1), allreduce_max(rounds, env));
+  const char* pos = static_cast<const char*>(data);
+  for (size_t round = 0; round < rounds; ++round) {
+    const size_t count = std::min(bytes, max_bytes);
+    MPI_File_write_at_all(mpi_file,
+                          offset,
+                          const_cast<char*>(pos),
+                          static_cast<int32_t>(count),
+                          MPI_BYTE,
+                          MPI_STATUS_IGNORE);
+    pos += count;
+    offset += count;
+    bytes -= count;
+  }
+}
+
+static inline void read_at_all(MPI_File& mpi_file, MPI_Offset offset,
+  void* data, size_t bytes, environment env = environment()) {
+
+  const size_t max_bytes = env.mpi_max_int();
+  size_t rounds = (bytes + max_bytes - 1) / max_bytes;
+  rounds = std::max(size_t(1), allreduce_max(rounds, env));
+  char* pos = static_cast<char*>(data);
+  for (size_t round = 0; round < rounds; ++round) {
+    const size_t count = std::min(bytes, max_bytes);
+    MPI_File_read_at_all(mpi_file,
+                         offset,
+                         pos,
+                         static_cast<int32_t>(count),
+                         MPI_BYTE,
+                         MPI_STATUS_IGNORE);
+    pos += count;
+    offset += count;
+    bytes -= count;
+  }
+}
+
+} // namespace dsss::mpi
+
+/******************************************************************************/
@@ -18,7 +18,7 @@
 
 namespace dsss::mpi {
 
-template <typename DataType, size_t max_char>
+template <typename DataType>
 class inducer {
 
 public:
@@ -230,8 +230,6 @@ private:
   std::vector<int32_t> rc_buffer_;
   std::vector<int32_t> sd_buffer_;
   std::vector<int32_t> rd_buffer_;
-
-  static constexpr size_t width_ = max_char + 1;
 }; // class induce
 
 } // namespace dsss::mpi
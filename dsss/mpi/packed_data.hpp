@@ -0,0 +1,222 @@
+/*******************************************************************************
+ * mpi/packed_data.hpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <mpi.h>
+#include <string>
+#include <vector>
+
+#include "mpi/allgather.hpp"
+#include "mpi/allreduce.hpp"
+#include "mpi/environment.hpp"
+#include "mpi/file_io.hpp"
+
+namespace dsss::mpi {
+
+// Files written by write_packed_data start with a header consisting of 64-bit
+// words: the magic number, the number of entries n, the number of bits per
+// entry, the number of blocks b, and the b + 1 offsets of the first entries of
+// all blocks (the last one is n). Each block is written by one PE. Its entries
+// are bit-packed and padded to a multiple of 64 bits. Hence, the position of
+// each entry in the file can be computed using only the header.
+struct packed_header {
+  static constexpr std::uint64_t magic = 0x31415353534b4350ULL;
+
+  std::uint64_t size = 0;
+  std::uint64_t width = 0;
+  std::vector<std::uint64_t> block_offsets;
+
+  size_t header_words() const {
+    return 4 + block_offsets.size();
+  }
+
+  static std::uint64_t block_words(const std::uint64_t entries,
+                                   const std::uint64_t width) {
+    return ((entries * width) + 63) / 64;
+  }
+
+  // Offset (in 64-bit words) of the first word of the block.
+  std::uint64_t block_start(const size_t block) const {
+    std::uint64_t result = header_words();
+    for (size_t i = 0; i < block; ++i) {
+      result += block_words(block_offsets[i + 1] - block_offsets[i], width);
+    }
+    return result;
+  }
+};
+
+static inline std::uint64_t packed_width(const std::uint64_t max_value) {
+  std::uint64_t width = 1;
+  while (width < 64 && (max_value >> width) > 0) { ++width; }
+  return width;
+}
+
+// Returns the entry at the given position (in bits) of the packed words.
+static inline std::uint64_t unpack_entry(const std::uint64_t* words,
+  const std::uint64_t bit_pos, const std::uint64_t width) {
+
+  const std::uint64_t mask = (width == 64) ?
+    ~std::uint64_t(0) : ((std::uint64_t(1) << width) - 1);
+  const std::uint64_t word = bit_pos / 64;
+  const std::uint64_t offset = bit_pos % 64;
+  std::uint64_t result = words[word] >> offset;
+  if (offset + width > 64) {
+    result |= words[word + 1] << (64 - offset);
+  }
+  return result & mask;
+}
+
+// Writes the distributed data using ceil(log2(max + 1)) bits per entry, where
+// max is the largest entry of all PEs.
+template <typename DataType>
+static void write_packed_data(std::vector<DataType>& local_data,
+  const std::string file_name, const io_hints& hints = io_hints(),
+  environment env = environment()) {
+
+  std::uint64_t local_max = 0;
+  for (const auto& value : local_data) {
+    local_max = std::max(local_max, std::uint64_t(value));
+  }
+  const std::uint64_t width = packed_width(
+    dsss::mpi::allreduce_max(local_max, env));
+  std::uint64_t local_size = local_data.size();
+  auto sizes = dsss::mpi::allgather(local_size, env);
+
+  packed_header header;
+  header.width = width;
+  header.block_offsets.push_back(0);
+  for (const auto& size : sizes) {
+    header.block_offsets.push_back(header.block_offsets.back() + size);
+  }
+  header.size = header.block_offsets.back();
+
+  std::vector<std::uint64_t> words(
+    packed_header::block_words(local_size, width), 0);
+  for (std::uint64_t i = 0; i < local_size; ++i) {
+    const std::uint64_t value = local_data[i];
+    const std::uint64_t word = (i * width) / 64;
+    const std::uint64_t offset = (i * width) % 64;
+    words[word] |= value << offset;
+    if (offset + width > 64) {
+      words[word + 1] |= value >> (64 - offset);
+    }
+  }
+
+  MPI_File mpi_file = open_file(file_name, MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                                hints, env);
+  MPI_File_set_size(mpi_file, 0);
+
+  if (env.rank() == 0) {
+    std::vector<std::uint64_t> header_words = { packed_header::magic,
+      header.size, header.width, header.block_offsets.size() - 1 };
+    std::copy(header.block_offsets.begin(), header.block_offsets.end(),
+              std::back_inserter(header_words));
+    MPI_File_write_at(mpi_file,
+                      0,
+                      header_words.data(),
+                      header_words.size() * sizeof(std::uint64_t),
+                      MPI_BYTE,
+                      MPI_STATUS_IGNORE);
+  }
+  write_at_all(mpi_file,
+               header.block_start(env.rank()) * sizeof(std::uint64_t),
+               words.data(),
+               words.size() * sizeof(std::uint64_t),
+               env);
+  MPI_File_close(&mpi_file);
+}
+
+// Reads the header of a file written by write_packed_data. Returns an empty
+// header (width 0) if the file has not been written by write_packed_data.
+static packed_header read_packed_header(MPI_File& mpi_file) {
+  packed_header header;
+  std::uint64_t first_words[4] = { 0, 0, 0, 0 };
+  MPI_File_read_at(mpi_file,
+                   0,
+                   first_words,
+                   4 * sizeof(std::uint64_t),
+                   MPI_BYTE,
+                   MPI_STATUS_IGNORE);
+  if (first_words[0] != packed_header::magic) {
+    return header;
+  }
+  header.size = first_words[1];
+  header.width = first_words[2];
+  header.block_offsets.resize(first_words[3] + 1);
+  MPI_File_read_at(mpi_file,
+                   4 * sizeof(std::uint64_t),
+                   header.block_offsets.data(),
+                   header.block_offsets.size() * sizeof(std::uint64_t),
+                   MPI_BYTE,
+                   MPI_STATUS_IGNORE);
+  return header;
+}
+
+// Reads a file written by write_packed_data. Independent of the number of PEs
+// that have written the file, the data is distributed the same way as by
+// read_data. Only the words containing the local entries are read.
+template <typename DataType>
+static std::vector<DataType> read_packed_data(const std::string file_name,
+  const io_hints& hints = io_hints(), environment env = environment()) {
+
+  MPI_File mpi_file = open_file(file_name, MPI_MODE_RDONLY, hints, env);
+
+  packed_header header = read_packed_header(mpi_file);
+
+  size_t local_slice_size = header.size / env.size();
+  int64_t larger_slices = header.size % env.size();
+
+  size_t offset;
+  if (env.rank() < larger_slices) {
+    ++local_slice_size;
+    offset = local_slice_size * env.rank();
+  } else {
+    offset = larger_slices * (local_slice_size + 1);
+    offset += (env.rank() - larger_slices) * local_slice_size;
+  }
+
+  std::vector<DataType> result;
+  result.reserve(local_slice_size);
+  const size_t end = offset + local_slice_size;
+  std::vector<std::uint64_t> words;
+  for (size_t block = 0; block + 1 < header.block_offsets.size() &&
+         result.size() < local_slice_size; ++block) {
+    const size_t block_begin = header.block_offsets[block];
+    const size_t block_end = header.block_offsets[block + 1];
+    if (block_end <= offset || block_begin >= end) { continue; }
+
+    // Read only the words containing the requested entries of this block.
+    const size_t first = std::max(offset, block_begin) - block_begin;
+    const size_t last = std::min(end, block_end) - block_begin;
+    const std::uint64_t first_word = (first * header.width) / 64;
+    const std::uint64_t last_word = ((last * header.width) + 63) / 64;
+    words.resize(last_word - first_word);
+    MPI_File_read_at(mpi_file,
+                     (header.block_start(block) + first_word) *
+                       sizeof(std::uint64_t),
+                     words.data(),
+                     words.size() * sizeof(std::uint64_t),
+                     MPI_BYTE,
+                     MPI_STATUS_IGNORE);
+    for (size_t i = first; i < last; ++i) {
+      result.emplace_back(DataType(unpack_entry(words.data(),
+        (i * header.width) - (first_word * 64), header.width)));
+    }
+  }
+
+  MPI_File_close(&mpi_file);
+  return result;
+}
+
+} // namespace dsss::mpi
+
+/******************************************************************************/
@@ -8,10 +8,12 @@
 
 #pragma once
 
+#include <algorithm>
 #include <mpi.h>
 #include <vector>
 
 #include "mpi/allreduce.hpp"
+#include "mpi/alltoall.hpp"
 #include "mpi/environment.hpp"
 #include "mpi/scan.hpp"
 #include "mpi/type_mapper.hpp"
@@ -25,7 +27,8 @@ public:
   requestable_array(std::vector<DataType>& data,
                     size_t total_size,
                     environment env = environment())
-    : local_size_(data.size()), slice_size_(total_size / env.size()),
+    : local_size_(data.size()),
+      slice_size_(std::max<size_t>(1, total_size / env.size())),
       data_(data.data()), env_(env) {
     
     MPI_Win_create(data_,
@@ -66,6 +69,17 @@ public:
 
   template <typename IndexType>
   std::vector<DataType> request2(std::vector<IndexType>& request_positions) {
+    return request(request_positions,
+                   [this](const size_t pos) { return data_[pos]; });
+  }
+
+  // Like request2, but the answer for each requested position is computed by
+  // the PE containing it, using the answer function, which is given the local
+  // position.
+  template <typename IndexType, typename AnswerFunction>
+  auto request(std::vector<IndexType>& request_positions,
+               AnswerFunction answer) {
+    using AnswerType = decltype(answer(size_t(0)));
 
     auto compute_target_rank = [&](IndexType pos) {
       return std::min<int32_t>(pos / slice_size_, env_.size() - 1);
@@ -90,20 +104,26 @@ public:
         request_positions[i] - (ranks[i] * slice_size_);
     }
 
-    auto [rec_count, rec_req] = alltoallv_counts(normalize_pos, hist);
-    for (auto& req : rec_req) {
-      req = data_[req];
-    }
+    auto [rec_count, rec_req] = alltoallv_counts(normalize_pos, hist, env_);
+    normalize_pos.clear();
+    normalize_pos.shrink_to_fit();
 
-    normalize_pos = alltoallv_small(rec_req, rec_count);
+    // The answers are sent using AnswerType, as the values may not fit in the
+    // 32-bit positions.
+    std::vector<AnswerType> answers;
+    answers.reserve(rec_req.size());
+    for (const auto req : rec_req) {
+      answers.push_back(answer(size_t(req)));
+    }
+    answers = alltoallv_small(answers, rec_count, env_);
     starting_positions[0] = 0;
     for (int32_t i = 1; i < env_.size(); ++i) {
       starting_positions[i] = starting_positions[i - 1] + hist[i - 1];
     }
 
-    std::vector<DataType> result(request_positions.size());
+    std::vector<AnswerType> result(request_positions.size());
     for (size_t i = 0; i < request_positions.size(); ++i) {
-      result[i] = normalize_pos[starting_positions[ranks[i]]++];
+      result[i] = answers[starting_positions[ranks[i]]++];
     }
     return result;
   }
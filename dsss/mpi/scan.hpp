@@ -8,7 +8,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include "mpi.h"
+#include <vector>
 
 #include "mpi/allgather.hpp"
 #include "mpi/broadcast.hpp"
@@ -33,6 +35,44 @@ DataType ex_prefix_sum(DataType local_data, environment const& env = environment
   return result;
 }
 
+// Element-wise exclusive prefix sum of vectors, which have the same size on
+// all PEs.
+template <typename DataType>
+std::vector<DataType> ex_prefix_sum(std::vector<DataType>& local_data,
+                                    environment const& env = environment()) {
+  static_assert(std::numeric_limits<DataType>::is_integer,
+    "Only integers are allowed for ex_prefix_sum.");
+
+  std::vector<DataType> result(local_data.size(), DataType(0));
+  MPI_Exscan(local_data.data(),
+             result.data(),
+             local_data.size() * type_mapper<DataType>::factor(),
+             type_mapper<DataType>::type(),
+             MPI_SUM,
+             env.communicator());
+  if (env.rank() == 0) {
+    std::fill(result.begin(), result.end(), DataType(0));
+  }
+  return result;
+}
+
+template <typename DataType>
+DataType ex_prefix_max(DataType local_data,
+                       environment const& env = environment()) {
+  static_assert(std::numeric_limits<DataType>::is_integer,
+    "Only integers are allowed for ex_prefix_max.");
+
+  DataType result;
+  MPI_Exscan(&local_data,
+             &result,
+             type_mapper<DataType>::factor(),
+             type_mapper<DataType>::type(),
+             MPI_MAX,
+             env.communicator());
+  if (env.rank() == 0) { result = DataType(0); }
+  return result;
+}
+
 template <typename DataType>
 DataType rev_ex_prefix_sum(DataType local_data,
                            environment const& env = environment()) {
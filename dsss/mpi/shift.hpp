@@ -150,6 +150,55 @@ static inline std::vector<DataType> shift_right(DataType* send_data,
   return receive_data;
 }
 
+// Like shift_left, but a PE only sends its data to the left neighbor if send
+// is true and only receives data from the right neighbor if receive is true.
+// Both neighbors have to agree on whether they exchange data.
+template <typename DataType>
+static inline std::vector<DataType> shift_left_if(const DataType* send_data,
+  std::size_t count, const bool send, const bool receive,
+  environment env = environment()) {
+
+  std::int32_t destination = MPI_PROC_NULL;
+  if (send && env.rank() > 0) {
+    destination = env.rank() - 1;
+  }
+  std::int32_t source = MPI_PROC_NULL;
+  if (receive && env.rank() + 1 < env.size()) {
+    source = env.rank() + 1;
+  }
+
+  std::size_t receive_count = 0;
+  data_type_mapper<std::size_t> count_dtm;
+  MPI_Sendrecv(&count,
+               1,
+               count_dtm.get_mpi_type(),
+               destination,
+               0, // chose arbitrary tag
+               &receive_count,
+               1,
+               count_dtm.get_mpi_type(),
+               source,
+               MPI_ANY_TAG,
+               env.communicator(),
+               MPI_STATUS_IGNORE);
+
+  std::vector<DataType> receive_data(receive_count);
+  data_type_mapper<DataType> dtm;
+  MPI_Sendrecv(const_cast<DataType*>(send_data),
+               count,
+               dtm.get_mpi_type(),
+               destination,
+               0, // chose arbitrary tag
+               receive_data.data(),
+               receive_count,
+               dtm.get_mpi_type(),
+               source,
+               MPI_ANY_TAG,
+               env.communicator(),
+               MPI_STATUS_IGNORE);
+  return receive_data;
+}
+
 static inline std::vector<dsss::char_type> shift_string_left(
   dsss::string send_data, environment env = environment()) {
 
@@ -9,10 +9,21 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
 #include <iterator>
 #include <limits>
+#include <mpi.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 #include "ips4o.hpp"
 #include <tlx/container/loser_tree.hpp>
 
@@ -20,27 +31,308 @@
 #include "mpi/allreduce.hpp"
 //#include "mpi/distribute_data.hpp"
 #include "mpi/environment.hpp"
+#include "mpi/scan.hpp"
+#include "mpi/type_mapper.hpp"
 
 #include "util/macros.hpp"
 
 namespace dsss::mpi {
 
+// Minimum number of elements per thread for which the local sorting and the
+// merging of the received data are parallelized.
+static constexpr size_t min_elements_per_thread = size_t(1) << 16;
+
+static inline size_t local_threads(const size_t elements) {
+#if defined(_OPENMP)
+  return std::max<size_t>(1, std::min<size_t>(omp_get_max_threads(),
+    elements / min_elements_per_thread));
+#else
+  (void) elements;
+  return 1;
+#endif
+}
+
+// Sorts the local data using all threads of the PE. The number of threads is
+// the one used by OpenMP (e.g., set with OMP_NUM_THREADS).
+template <typename Iterator, class Compare>
+inline void local_sort(Iterator begin, Iterator end, Compare comp) {
+#if defined(_OPENMP)
+  if (local_threads(std::distance(begin, end)) > 1) {
+    ips4o::parallel::sort(begin, end, comp);
+    return;
+  }
+#endif
+  ips4o::sort(begin, end, comp);
+}
+
+// Merges the sorted runs [run_begins[i], run_begins[i + 1]) of the data. The
+// output is split into one part per thread using splitters sampled from all
+// runs, and each part is merged independently using a loser tree. If Stable
+// is set, equal elements are ordered by their runs.
+template <bool Stable = false, typename DataType, class Compare>
+inline std::vector<DataType> multiway_merge(std::vector<DataType> const& data,
+  std::vector<size_t> const& run_begins, Compare comp) {
+
+  const size_t runs = run_begins.size() - 1;
+  const size_t parts = local_threads(data.size());
+
+  std::vector<DataType> splitters;
+  if (parts > 1) {
+    std::vector<DataType> samples;
+    for (size_t run = 0; run < runs; ++run) {
+      const size_t run_size = run_begins[run + 1] - run_begins[run];
+      for (size_t i = 1; i < parts && run_size > 0; ++i) {
+        samples.emplace_back(data[run_begins[run] + (i * run_size) / parts]);
+      }
+    }
+    std::sort(samples.begin(), samples.end(), comp);
+    for (size_t i = 1; i < parts; ++i) {
+      splitters.emplace_back(samples[(i * samples.size()) / parts]);
+    }
+  }
+  // Part i contains all elements of each run that are not smaller than the
+  // (i - 1)-th splitter and smaller than the i-th splitter.
+  std::vector<size_t> part_begins((parts + 1) * runs);
+  std::vector<size_t> output_begins(parts + 1, 0);
+  for (size_t part = 0; part <= parts; ++part) {
+    for (size_t run = 0; run < runs; ++run) {
+      size_t& begin = part_begins[(part * runs) + run];
+      if (part == 0) {
+        begin = run_begins[run];
+      } else if (part == parts) {
+        begin = run_begins[run + 1];
+      } else {
+        begin = std::lower_bound(data.begin() + run_begins[run],
+          data.begin() + run_begins[run + 1], splitters[part - 1], comp) -
+          data.begin();
+      }
+      if (part > 0) {
+        output_begins[part] +=
+          begin - part_begins[((part - 1) * runs) + run];
+      }
+    }
+    if (part > 0) { output_begins[part] += output_begins[part - 1]; }
+  }
+
+  std::vector<DataType> result(data.size());
+  DSSS_OMP(parallel for)
+  for (size_t part = 0; part < parts; ++part) {
+    std::vector<size_t> pos(part_begins.begin() + (part * runs),
+      part_begins.begin() + ((part + 1) * runs));
+    std::vector<size_t> end(part_begins.begin() + ((part + 1) * runs),
+      part_begins.begin() + ((part + 2) * runs));
+
+    tlx::LoserTreeCopy<Stable, DataType, Compare> lt(runs, comp);
+    size_t filled_sources = 0;
+    for (size_t run = 0; run < runs; ++run) {
+      if (pos[run] < end[run]) {
+        lt.insert_start(&data[pos[run]], run, false);
+        ++filled_sources;
+      } else {
+        lt.insert_start(nullptr, run, true);
+      }
+    }
+    lt.init();
+
+    size_t output_pos = output_begins[part];
+    while (filled_sources) {
+      const size_t source = lt.min_source();
+      result[output_pos++] = data[pos[source]++];
+      if (pos[source] < end[source]) {
+        lt.delete_min_insert(&data[pos[source]], false);
+      } else {
+        lt.delete_min_insert(nullptr, true);
+        --filled_sources;
+      }
+    }
+  }
+  return result;
+}
+
+// Sends interval_sizes[i] elements of the sorted local data (from left to
+// right) to PE i and merges the received sorted runs. If Stable is set, equal
+// elements received from different PEs are ordered by the PEs' ranks.
+template <bool Stable = false, typename DataType, class Compare>
+inline void exchange_sorted_data(std::vector<DataType>& local_data,
+  std::vector<size_t>& interval_sizes, Compare comp,
+  environment env = environment()) {
+
+  std::vector<size_t> receiving_sizes = alltoall(interval_sizes, env);
+
+  local_data = alltoallv(local_data, interval_sizes, env);
+
+  // The data received from each PE is sorted, hence, we merge these runs
+  // instead of sorting the data again.
+  if (local_data.size() > 0) {
+    std::vector<size_t> run_begins(env.size() + 1, 0);
+    for (int32_t i = 0; i < env.size(); ++i) {
+      run_begins[i + 1] = run_begins[i] + receiving_sizes[i];
+    }
+    local_data = multiway_merge<Stable>(local_data, run_begins, comp);
+  }
+}
+
+// Number of elements per PE below which sort uses hypercube quicksort. For so
+// few elements, the p - 1 splitters per PE and the alltoallv of sample sort
+// only add latency, whereas hypercube quicksort needs O(log^2 p) messages.
+inline size_t hypercube_sort_threshold = 1024;
+
+// Exchanges the data with the partner PE, which has to call this, too.
+template <typename DataType>
+inline std::vector<DataType> exchange_with(std::vector<DataType>& send_data,
+  const int32_t partner, environment env = environment()) {
+
+  std::uint64_t send_size = send_data.size();
+  std::uint64_t receive_size = 0;
+  MPI_Sendrecv(&send_size,
+               1,
+               type_mapper<std::uint64_t>::type(),
+               partner,
+               0, // chose arbitrary tag
+               &receive_size,
+               1,
+               type_mapper<std::uint64_t>::type(),
+               partner,
+               0,
+               env.communicator(),
+               MPI_STATUS_IGNORE);
+  std::vector<DataType> receive_data(receive_size);
+  data_type_mapper<DataType> dtm;
+  MPI_Sendrecv(send_data.data(),
+               static_cast<int32_t>(send_size),
+               dtm.get_mpi_type(),
+               partner,
+               0,
+               receive_data.data(),
+               static_cast<int32_t>(receive_size),
+               dtm.get_mpi_type(),
+               partner,
+               0,
+               env.communicator(),
+               MPI_STATUS_IGNORE);
+  return receive_data;
+}
+
+// Sorts the (locally sorted) data using hypercube quicksort. If p is not a
+// power of two, the first pairs of PEs form a single node of the hypercube,
+// i.e., PE 2i + 1 hands its data to PE 2i before and receives half of PE 2i's
+// sorted data afterwards. In each of the d rounds, each subcube splits its
+// data at a common pivot, which is the weighted median of the medians of its
+// nodes. The medians are gathered within the subcube by recursive doubling.
+// Then, each node exchanges the elements belonging to the other half of the
+// subcube with its partner in that half. Like in sample sort, all elements
+// equal to each other end up on the same PE (those equal to the pivot belong
+// to the upper half), which the ranking of sorted tuples relies on.
 template <typename DataType, class Compare>
-inline void sort(std::vector<DataType>& local_data, Compare comp,
+inline void hypercube_quicksort(std::vector<DataType>& local_data,
+  Compare comp, environment env = environment()) {
+
+  auto merge_received = [&](std::vector<DataType>& received) {
+    std::vector<DataType> merged(local_data.size() + received.size());
+    std::merge(local_data.begin(), local_data.end(), received.begin(),
+      received.end(), merged.begin(), comp);
+    local_data = std::move(merged);
+  };
+
+  int32_t cube_size = 1;
+  while (2 * cube_size <= env.size()) { cube_size *= 2; }
+  const int32_t pairs = env.size() - cube_size;
+  auto node_rank = [&](const int32_t node) {
+    return (node < pairs) ? (2 * node) : (node + pairs);
+  };
+  const int32_t node = (env.rank() < 2 * pairs) ?
+    (env.rank() / 2) : (env.rank() - pairs);
+  const bool has_pair = (node < pairs);
+
+  if (has_pair && env.rank() % 2 == 1) {
+    exchange_with(local_data, env.rank() - 1, env);
+    std::vector<DataType> nothing;
+    local_data = exchange_with(nothing, env.rank() - 1, env);
+    return;
+  } else if (has_pair) {
+    std::vector<DataType> nothing;
+    auto received = exchange_with(nothing, env.rank() + 1, env);
+    merge_received(received);
+  }
+
+  struct median {
+    DataType value;
+    std::uint64_t weight;
+  };
+  for (int32_t dimension = cube_size / 2; dimension > 0; dimension /= 2) {
+    std::vector<median> medians;
+    if (!local_data.empty()) {
+      medians.push_back(median { local_data[local_data.size() / 2],
+        local_data.size() });
+    }
+    for (int32_t bit = 1; bit <= dimension; bit *= 2) {
+      auto received = exchange_with(medians, node_rank(node ^ bit), env);
+      std::move(received.begin(), received.end(),
+        std::back_inserter(medians));
+    }
+    // All nodes of the subcube have the same medians (in different orders)
+    if (medians.empty()) { continue; }
+    std::sort(medians.begin(), medians.end(),
+      [&comp](const median& a, const median& b) {
+        return comp(a.value, b.value);
+      });
+    size_t total_weight = 0;
+    for (const auto& m : medians) { total_weight += m.weight; }
+    size_t pivot = 0;
+    for (size_t weight = medians[0].weight; 2 * weight < total_weight;) {
+      weight += medians[++pivot].weight;
+    }
+
+    // Elements smaller than the pivot belong to the lower half of the subcube
+    auto split = std::lower_bound(local_data.begin(), local_data.end(),
+      medians[pivot].value, comp);
+    std::vector<DataType> send_data;
+    if ((node & dimension) == 0) {
+      send_data.assign(split, local_data.end());
+      local_data.erase(split, local_data.end());
+    } else {
+      send_data.assign(local_data.begin(), split);
+      local_data.erase(local_data.begin(), split);
+    }
+    auto received = exchange_with(send_data, node_rank(node ^ dimension),
+      env);
+    merge_received(received);
+  }
+
+  if (has_pair) {
+    // Equal elements are not split between the PEs of the pair
+    const size_t half = (local_data.size() + 1) / 2;
+    const size_t keep = (half == local_data.size()) ? half :
+      size_t(std::lower_bound(local_data.begin(), local_data.begin() + half,
+        local_data[half], comp) - local_data.begin());
+    std::vector<DataType> send_data(local_data.begin() + keep,
+      local_data.end());
+    local_data.resize(keep);
+    exchange_with(send_data, env.rank() + 1, env);
+  }
+}
+
+// Computes how many elements of the sorted local data are sent to each PE
+// using splitters sampled from the sorted data of all PEs. The splitters are
+// projections of the elements (e.g., the elements themselves or their keys)
+// and comp compares the projections.
+template <typename DataType, class Projection, class Compare>
+inline std::vector<size_t> sample_interval_sizes(
+  std::vector<DataType> const& local_data, Projection project, Compare comp,
   environment env = environment()) {
 
-  // Sort locally
-  ips4o::sort(local_data.begin(), local_data.end(), comp);
+  using splitter_type =
+    std::decay_t<decltype(project(std::declval<const DataType&>()))>;
 
   // Compute the local splitters given the sorted data
-  const size_t local_n = local_data.size();
+  size_t local_n = local_data.size();
   auto nr_splitters = std::min<size_t>(env.size() - 1, local_n);
   auto splitter_dist = local_n / (nr_splitters + 1);
 
-  std::vector<DataType> local_splitters;
+  std::vector<splitter_type> local_splitters;
   local_splitters.reserve(nr_splitters);
   for (size_t i = 1; i <= nr_splitters; ++i) {
-    local_splitters.emplace_back(local_data[i * splitter_dist]);
+    local_splitters.emplace_back(project(local_data[i * splitter_dist]));
   }
 
   // Distribute the local splitters, which results in the set of global
@@ -63,9 +355,9 @@ inline void sort(std::vector<DataType>& local_data, Compare comp,
   for (size_t i = 0; i < local_splitters.size(); ++i) {
     element_pos = ((i + 1) * splitter_dist);
     while(element_pos > 0 && !comp(
-      local_data[element_pos], local_splitters[i])) { --element_pos; }
+      project(local_data[element_pos]), local_splitters[i])) { --element_pos; }
     while (element_pos < local_n && comp(
-      local_data[element_pos], local_splitters[i])) { ++element_pos; }
+      project(local_data[element_pos]), local_splitters[i])) { ++element_pos; }
     interval_sizes.emplace_back(element_pos);
   }
   interval_sizes.emplace_back(local_n);
@@ -73,69 +365,337 @@ inline void sort(std::vector<DataType>& local_data, Compare comp,
     interval_sizes[i] -= interval_sizes[i - 1];
   }
 
-  std::vector<size_t> receiving_sizes = alltoall(interval_sizes);
-
   for (int64_t i = interval_sizes.size(); i < env.size(); ++i) {
     interval_sizes.emplace_back(0);
   }
+  return interval_sizes;
+}
 
-  local_data = alltoallv(local_data, interval_sizes, env);
+template <typename DataType, class Compare>
+inline void sort(std::vector<DataType>& local_data, Compare comp,
+  environment env = environment()) {
 
-  if (false && local_data.size() > 1024 * 1024) {
-    std::vector<decltype(local_data.cbegin())> string_it(
-      env.size(), local_data.cbegin());
-    std::vector<decltype(local_data.cbegin())> end_it(
-      env.size(), local_data.cbegin() + receiving_sizes[0]);
+  // Sort locally
+  local_sort(local_data.begin(), local_data.end(), comp);
+  if (env.size() == 1) { return; }
 
-    size_t received_elements = receiving_sizes[0];
-    for (int32_t i = 1; i < env.size(); ++i) {
-      string_it[i] = string_it[i - 1] + receiving_sizes[i - 1];
-      received_elements += receiving_sizes[i];
-      end_it[i] = end_it[i - 1] + receiving_sizes[i];
-    }
+  size_t local_n = local_data.size();
+  if (allreduce_sum(local_n, env) <
+      hypercube_sort_threshold * size_t(env.size())) {
+    hypercube_quicksort(local_data, comp, env);
+    return;
+  }
 
-    struct item_compare {
-      item_compare(Compare compare) : comp_(compare) { }
+  auto interval_sizes = sample_interval_sizes(local_data,
+    [](const DataType& x) -> const DataType& { return x; }, comp, env);
+  exchange_sorted_data(local_data, interval_sizes, comp, env);
+}
 
-      bool operator ()(const DataType& a, const DataType& b) {
-        return comp_(a, b);
-      }
+// Finds the positions at which the sorted local data has to be split, such
+// that the sorted data is distributed like by distribute_data, i.e., each PE
+// receives total_size / p elements and the last PE also the remaining ones.
+// The positions are found using a distributed multisequence selection: equal
+// elements are ordered by PE and position, which makes all elements distinct.
+// For each split, the weighted median of the medians of the PEs' candidate
+// intervals is used as pivot. The pivot's global rank decides which part of
+// the candidate intervals can be discarded, which is at least a quarter of
+// all candidates. Hence, O(log n) rounds suffice.
+template <typename DataType, class Compare>
+inline std::vector<size_t> exact_interval_sizes(
+  std::vector<DataType> const& local_data, Compare comp,
+  environment env = environment()) {
+
+  size_t local_n = local_data.size();
+  const size_t total_n = allreduce_sum(local_n, env);
+  const size_t slice_size = std::max<size_t>(1, total_n / env.size());
+  const size_t splits = env.size() - 1;
 
-    private:
-      Compare comp_;
-    }; // struct item_compare
+  // The i-th split is the position in [lower[i], upper[i]], such that the
+  // elements left of it on all PEs are exactly the ranks[i] smallest ones.
+  std::vector<size_t> ranks(splits);
+  std::vector<size_t> lower(splits, 0);
+  std::vector<size_t> upper(splits, local_n);
+  for (size_t i = 0; i < splits; ++i) {
+    ranks[i] = std::min(total_n, (i + 1) * slice_size);
+  }
 
-    tlx::LoserTreeCopy<false, DataType, item_compare> lt(env.size(),
-      item_compare(comp));
+  struct candidate {
+    DataType value;
+    std::uint64_t weight;
+    std::uint64_t index;
+    std::uint64_t split;
+    std::int64_t rank;
+  };
+  auto candidate_less = [&comp](const candidate& a, const candidate& b) {
+    if (a.split != b.split) { return a.split < b.split; }
+    if (comp(a.value, b.value)) { return true; }
+    if (comp(b.value, a.value)) { return false; }
+    return std::tie(a.rank, a.index) < std::tie(b.rank, b.index);
+  };
 
-    size_t filled_sources = 0;
-    for (int32_t i = 0; i < env.size(); ++i) {
-      if (string_it[i] >= end_it[i]) { lt.insert_start(nullptr, i, true); }
-      else {
-        lt.insert_start(&*string_it[i], i, false);
-        ++filled_sources;
+  std::vector<size_t> sizes(2 * splits);
+  std::vector<size_t> counts(splits);
+  std::vector<std::int64_t> pivot_ranks(splits);
+  while (true) {
+    for (size_t i = 0; i < splits; ++i) {
+      sizes[i] = lower[i];
+      sizes[splits + i] = upper[i] - lower[i];
+    }
+    auto global_sizes = allreduce_sum(sizes, env);
+    // All PEs agree on the splits that are still active
+    std::vector<std::uint8_t> active(splits, false);
+    std::vector<candidate> local_candidates;
+    for (size_t i = 0; i < splits; ++i) {
+      if (global_sizes[i] == ranks[i]) {
+        upper[i] = lower[i];
+      } else if (global_sizes[i] + global_sizes[splits + i] == ranks[i]) {
+        lower[i] = upper[i];
+      } else {
+        active[i] = true;
+        if (lower[i] < upper[i]) {
+          const size_t middle = (lower[i] + upper[i]) / 2;
+          local_candidates.push_back(candidate { local_data[middle],
+            upper[i] - lower[i], middle, i, env.rank() });
+        }
       }
     }
+    if (std::find(active.begin(), active.end(), true) == active.end()) {
+      break;
+    }
 
-    lt.init();
+    auto candidates = allgatherv(local_candidates, env);
+    std::sort(candidates.begin(), candidates.end(), candidate_less);
+    std::vector<candidate> pivots;
+    for (size_t i = 0, weight = 0; i < candidates.size(); ++i) {
+      const size_t split = candidates[i].split;
+      if (i == 0 || candidates[i - 1].split != split) { weight = 0; }
+      if (weight < (global_sizes[splits + split] + 1) / 2) {
+        weight += candidates[i].weight;
+        if (weight >= (global_sizes[splits + split] + 1) / 2) {
+          pivots.push_back(candidates[i]);
+        }
+      }
+    }
 
-    std::vector<DataType> result;
-    result.reserve(local_data.size());
-    while (filled_sources) {
-      int32_t source = lt.min_source();
-      result.push_back(*string_it[source]);
-      ++string_it[source];
-      if (string_it[source] < end_it[source]) {
-        lt.delete_min_insert(&*string_it[source], false);
+    for (size_t i = 0, j = 0; i < splits; ++i) {
+      counts[i] = 0;
+      if (!active[i]) { continue; }
+      const candidate& pivot = pivots[j++];
+      pivot_ranks[i] = pivot.rank;
+      auto begin = local_data.begin() + lower[i];
+      auto end = local_data.begin() + upper[i];
+      if (env.rank() < pivot.rank) {
+        counts[i] = std::upper_bound(begin, end, pivot.value, comp) -
+          local_data.begin();
+      } else if (env.rank() > pivot.rank) {
+        counts[i] = std::lower_bound(begin, end, pivot.value, comp) -
+          local_data.begin();
       } else {
-        lt.delete_min_insert(nullptr, true);
-        --filled_sources;
+        counts[i] = pivot.index;
       }
     }
-    local_data = std::move(result);
-  } else if (local_data.size() > 0) {
-    ips4o::sort(local_data.begin(), local_data.end(), comp);
+    auto global_counts = allreduce_sum(counts, env);
+    for (size_t i = 0; i < splits; ++i) {
+      if (!active[i]) { continue; }
+      if (global_counts[i] < ranks[i]) {
+        // The pivot (and all smaller elements) are left of the split
+        lower[i] = counts[i] + (env.rank() == pivot_ranks[i] ? 1 : 0);
+      } else {
+        upper[i] = counts[i];
+        if (global_counts[i] == ranks[i]) { lower[i] = counts[i]; }
+      }
+    }
+  }
+
+  std::vector<size_t> interval_sizes(env.size());
+  for (size_t i = 0, begin = 0; i < splits; ++i) {
+    interval_sizes[i] = lower[i] - begin;
+    begin = lower[i];
   }
+  interval_sizes.back() = local_n - (splits > 0 ? lower.back() : 0);
+  return interval_sizes;
+}
+
+// Sorts the data like sort, but the sorted data is distributed like by
+// distribute_data afterwards, i.e., a subsequent distribute_data is not
+// necessary. Instead of sampled splitters, exact splitting positions are
+// computed (see exact_interval_sizes).
+template <typename DataType, class Compare>
+inline void balanced_sort(std::vector<DataType>& local_data, Compare comp,
+  environment env = environment()) {
+
+  local_sort(local_data.begin(), local_data.end(), comp);
+  if (env.size() == 1) { return; }
+  auto interval_sizes = exact_interval_sizes(local_data, comp, env);
+  exchange_sorted_data(local_data, interval_sizes, comp, env);
+}
+
+// Maps an integer (signed, unsigned, or one of the uint_types) to an unsigned
+// 64-bit integer with the same order.
+template <typename IntType>
+inline std::uint64_t radix_component(const IntType value) {
+  if constexpr (std::is_integral_v<IntType> && std::is_signed_v<IntType>) {
+    return std::uint64_t(std::int64_t(value)) ^ (std::uint64_t(1) << 63);
+  } else {
+    return static_cast<std::uint64_t>(value);
+  }
+}
+
+template <typename KeyType>
+struct is_tuple_key : std::false_type { };
+
+template <typename... IntTypes>
+struct is_tuple_key<std::tuple<IntTypes...>> : std::true_type { };
+
+// Maps a key, i.e., an integer or a tuple of integers, to an array of unsigned
+// 64-bit integers with the same (lexicographical) order.
+template <typename KeyType>
+inline auto radix_key(KeyType const& key) {
+  if constexpr (is_tuple_key<KeyType>::value) {
+    return std::apply([](auto const&... components) {
+      return std::array<std::uint64_t, sizeof...(components)> {
+        radix_component(components)... };
+    }, key);
+  } else {
+    return std::array<std::uint64_t, 1> { radix_component(key) };
+  }
+}
+
+// Stable LSD radix sort by the radix keys of the data, one byte per pass.
+// Bytes that are equal for all keys (e.g., the high bytes of small integers)
+// are skipped.
+template <typename DataType, class RadixKey>
+inline void lsd_radix_sort(std::vector<DataType>& data, RadixKey radix_key) {
+  if (data.size() < 2) { return; }
+
+  using key_type = std::decay_t<decltype(radix_key(data.front()))>;
+  constexpr size_t components = std::tuple_size<key_type>::value;
+
+  const key_type first_key = radix_key(data.front());
+  key_type varying_bits {};
+  for (const auto& element : data) {
+    const key_type key = radix_key(element);
+    for (size_t c = 0; c < components; ++c) {
+      varying_bits[c] |= key[c] ^ first_key[c];
+    }
+  }
+
+  std::vector<DataType> buffer(data.size());
+  for (size_t c = components; c-- > 0; ) {
+    for (size_t shift = 0; shift < 64; shift += 8) {
+      if (((varying_bits[c] >> shift) & 0xFF) == 0) { continue; }
+      std::array<size_t, 256> bucket_begins {};
+      for (const auto& element : data) {
+        ++bucket_begins[(radix_key(element)[c] >> shift) & 0xFF];
+      }
+      for (size_t i = 0, sum = 0; i < bucket_begins.size(); ++i) {
+        sum += std::exchange(bucket_begins[i], sum);
+      }
+      for (const auto& element : data) {
+        buffer[bucket_begins[(radix_key(element)[c] >> shift) & 0xFF]++] =
+          element;
+      }
+      data.swap(buffer);
+    }
+  }
+}
+
+// Sorts the local data stably by the keys extracted from the elements. If the
+// elements are larger than a (key, slot) pair, only the pairs are moved during
+// sorting and the elements are permuted once afterwards. The radix sort is
+// sequential, hence, if multiple threads can be used (see local_threads), the
+// (key, slot) pairs are sorted in parallel using local_sort instead. As the
+// slots are distinct, this is stable, too.
+template <typename DataType, class KeyExtractor>
+inline void local_sort_by_key(std::vector<DataType>& local_data,
+  KeyExtractor key) {
+
+  auto data_key = [&key](const DataType& x) { return radix_key(key(x)); };
+  using key_type = decltype(data_key(std::declval<const DataType&>()));
+
+  struct keyed_slot {
+    key_type key;
+    size_t slot;
+  };
+
+  const bool parallel = (local_threads(local_data.size()) > 1);
+  if (parallel || sizeof(DataType) > sizeof(keyed_slot)) {
+    std::vector<keyed_slot> keyed_slots(local_data.size());
+    DSSS_OMP(parallel for if(parallel))
+    for (size_t i = 0; i < local_data.size(); ++i) {
+      keyed_slots[i] = keyed_slot { data_key(local_data[i]), i };
+    }
+    if (parallel) {
+      local_sort(keyed_slots.begin(), keyed_slots.end(),
+        [](const keyed_slot& a, const keyed_slot& b) {
+          return std::tie(a.key, a.slot) < std::tie(b.key, b.slot);
+        });
+    } else {
+      lsd_radix_sort(keyed_slots, [](const keyed_slot& ks)
+        -> key_type const& { return ks.key; });
+    }
+    std::vector<DataType> sorted_data(local_data.size());
+    DSSS_OMP(parallel for if(parallel))
+    for (size_t i = 0; i < keyed_slots.size(); ++i) {
+      sorted_data[i] = std::move(local_data[keyed_slots[i].slot]);
+    }
+    local_data.swap(sorted_data);
+  } else {
+    lsd_radix_sort(local_data, data_key);
+  }
+}
+
+// Sorts the data stably by the keys extracted from the elements, which are
+// integers or tuples of integers (compared lexicographically). The data is
+// sorted locally using radix sort and the splitters consist only of keys.
+// Equal keys remain in the order of the PEs and the positions on the PEs.
+// Like sort, small inputs are sorted using hypercube quicksort. It is not
+// stable, hence, the keys are extended by the global positions of the
+// elements in this case.
+template <typename DataType, class KeyExtractor>
+inline void sort_by_key(std::vector<DataType>& local_data, KeyExtractor key,
+  environment env = environment()) {
+
+  local_sort_by_key(local_data, key);
+  if (env.size() == 1) { return; }
+
+  auto data_key = [&key](const DataType& x) { return radix_key(key(x)); };
+  using key_type = decltype(data_key(std::declval<const DataType&>()));
+
+  size_t local_n = local_data.size();
+  if (allreduce_sum(local_n, env) <
+      hypercube_sort_threshold * size_t(env.size())) {
+    struct positioned_element {
+      key_type key;
+      std::uint64_t position;
+      DataType data;
+    };
+    std::uint64_t position = local_n;
+    position = ex_prefix_sum(position, env);
+    std::vector<positioned_element> positioned_data;
+    positioned_data.reserve(local_n);
+    for (const auto& element : local_data) {
+      positioned_data.push_back(positioned_element {
+        data_key(element), position++, element });
+    }
+    hypercube_quicksort(positioned_data,
+      [](const positioned_element& a, const positioned_element& b) {
+        return std::tie(a.key, a.position) < std::tie(b.key, b.position);
+      }, env);
+    local_data.clear();
+    local_data.reserve(positioned_data.size());
+    for (const auto& element : positioned_data) {
+      local_data.emplace_back(element.data);
+    }
+    return;
+  }
+
+  auto interval_sizes = sample_interval_sizes(local_data, data_key,
+    std::less<key_type>(), env);
+  exchange_sorted_data<true>(local_data, interval_sizes,
+    [&data_key](const DataType& a, const DataType& b) {
+      return data_key(a) < data_key(b);
+    }, env);
 }
 
 } // namespace dsss::mpi
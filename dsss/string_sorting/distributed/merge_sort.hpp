@@ -18,6 +18,7 @@
 #include "mpi/environment.hpp"
 
 #include "util/indexed_string_set.hpp"
+#include "util/indexed_substring_set.hpp"
 #include "util/string.hpp"
 #include "util/string_set.hpp"
 
@@ -26,29 +27,28 @@ namespace dsss::sample_sort {
 static constexpr bool debug = false;
 static constexpr bool print_interval_details = debug && true;
 
+// Distributes locally sorted strings, such that the strings on PE i are
+// smaller than the strings on PE i + 1, and merges the received strings. The
+// local strings can also be substrings (see indexed_substring_set), they are
+// received as 0-terminated strings.
 template <typename IndexType,
-          void LocalIdxSorter(dsss::indexed_string<IndexType>*, std::size_t),
-          void LocalSorter(dsss::string*, std::size_t)>
-static inline void sample_sort(
-  dsss::indexed_string_set<IndexType>& local_string_set,
+          void LocalSorter(dsss::string*, std::size_t),
+          typename StringSet>
+static inline dsss::indexed_string_set<IndexType> exchange_sorted_strings(
+  StringSet& local_string_set,
   dsss::mpi::environment env = dsss::mpi::environment()) {
 
   std::size_t local_n = local_string_set.size();
   auto* local_strings = local_string_set.strings();
-  LocalIdxSorter(local_strings, local_n);
-
-  // There is only one PE, hence there is no need for distributed sorting 
-  if (env.size() == 1) {
-    return;
-  }
 
   auto nr_splitters = std::min<std::size_t>(env.size() - 1, local_n);
   auto splitter_dist = local_n / (nr_splitters + 1);
   std::vector<dsss::char_type> raw_splitters;
   for (std::size_t i = 1; i <= nr_splitters; ++i) {
-    const auto splitter = local_strings[i * splitter_dist].string;
-    std::copy_n(splitter, dsss::string_length(splitter) + 1,
+    const auto& splitter = local_strings[i * splitter_dist];
+    std::copy_n(splitter.string, dsss::string_length(splitter),
       std::back_inserter(raw_splitters));
+    raw_splitters.emplace_back(dsss::char_type(0));
   }
 
   // Gather all splitters and sort them to determine the final splitters
@@ -77,10 +77,10 @@ static inline void sample_sort(
   splitter_dist = local_n / (nr_splitters + 1);
   for (std::size_t i = 0; i < splitters.size(); ++i) {
     element_pos = (i + 1) * splitter_dist;
-    while(element_pos > 1 && !dsss::string_smaller_eq(
-      local_strings[element_pos].string, splitters[i])) { --element_pos; }
+    while (element_pos > 0 && !dsss::string_smaller_eq(
+      local_strings[element_pos - 1], splitters[i])) { --element_pos; }
     while (element_pos < local_n && dsss::string_smaller_eq(
-      local_strings[element_pos].string, splitters[i])) { ++element_pos; }
+      local_strings[element_pos], splitters[i])) { ++element_pos; }
     interval_sizes.emplace_back(element_pos);
   }
   interval_sizes.emplace_back(local_n);
@@ -117,13 +117,13 @@ static inline void sample_sort(
     if (env.rank() == 0) { std::cout << std::endl; }
   }
 
-  local_string_set = dsss::mpi::alltoallv_indexed_strings<IndexType>(
-    local_string_set, interval_sizes);
+  dsss::indexed_string_set<IndexType> received_set =
+    dsss::mpi::alltoallv_indexed_strings(local_string_set, interval_sizes);
 
-  std::vector<decltype(local_string_set.cbegin())> string_it(
-    env.size(), local_string_set.cbegin());
-  std::vector<decltype(local_string_set.cbegin())> end_it(
-    env.size(), local_string_set.cbegin() + receiving_sizes[0]);
+  std::vector<decltype(received_set.cbegin())> string_it(
+    env.size(), received_set.cbegin());
+  std::vector<decltype(received_set.cbegin())> end_it(
+    env.size(), received_set.cbegin() + receiving_sizes[0]);
 
   for (std::int32_t i = 1; i < env.size(); ++i) {
     string_it[i] = string_it[i - 1] + receiving_sizes[i - 1];
@@ -159,7 +159,7 @@ static inline void sample_sort(
   lt.init();
 
   std::vector<dsss::indexed_string<IndexType>> result;
-  result.reserve(local_string_set.size());
+  result.reserve(received_set.size());
   while (filled_sources) {
     std::int32_t source = lt.min_source();
     result.push_back(*string_it[source]);
@@ -171,7 +171,7 @@ static inline void sample_sort(
       --filled_sources;
     }
   }
-  local_string_set.update(std::move(result));
+  received_set.update(std::move(result));
 
   if constexpr (debug) {
     if (env.rank() == 0) {
@@ -179,6 +179,39 @@ static inline void sample_sort(
     }
     env.barrier();
   }
+  return received_set;
+}
+
+template <typename IndexType,
+          void LocalIdxSorter(dsss::indexed_string<IndexType>*, std::size_t),
+          void LocalSorter(dsss::string*, std::size_t)>
+static inline void sample_sort(
+  dsss::indexed_string_set<IndexType>& local_string_set,
+  dsss::mpi::environment env = dsss::mpi::environment()) {
+
+  LocalIdxSorter(local_string_set.strings(), local_string_set.size());
+
+  // There is only one PE, hence there is no need for distributed sorting 
+  if (env.size() == 1) {
+    return;
+  }
+  local_string_set = exchange_sorted_strings<IndexType, LocalSorter>(
+    local_string_set, env);
+}
+
+// Sorts substrings that point into the text. They are only copied when they
+// are sent to the PE responsible for them.
+template <typename IndexType,
+          void LocalIdxSorter(dsss::indexed_substring<IndexType>*,
+                              std::size_t),
+          void LocalSorter(dsss::string*, std::size_t)>
+static inline dsss::indexed_string_set<IndexType> sample_sort(
+  dsss::indexed_substring_set<IndexType>& local_substring_set,
+  dsss::mpi::environment env = dsss::mpi::environment()) {
+
+  LocalIdxSorter(local_substring_set.strings(), local_substring_set.size());
+  return exchange_sorted_strings<IndexType, LocalSorter>(local_substring_set,
+    env);
 }
 
 template <void LocalSorter(dsss::string*, std::size_t)>
@@ -247,8 +280,8 @@ static inline void sample_sort(dsss::string_set& local_string_set,
   splitter_dist = local_n / (nr_splitters + 1);
   for (std::size_t i = 0; i < splitters.size(); ++i) {
     element_pos = (i + 1) * splitter_dist;
-    while(element_pos > 1 && !dsss::string_smaller_eq(
-      local_strings[element_pos], splitters[i])) { --element_pos; }
+    while (element_pos > 0 && !dsss::string_smaller_eq(
+      local_strings[element_pos - 1], splitters[i])) { --element_pos; }
     while (element_pos < local_n && dsss::string_smaller_eq(
       local_strings[element_pos], splitters[i])) { ++element_pos; }
     interval_sizes.emplace_back(element_pos);
@@ -50,6 +50,29 @@ static inline void inssort(dsss::indexed_string_set<IndexType>& strings) {
   inssort(strings.strings(), strings.size());
 }
 
+template <typename IndexType>
+static inline void inssort(dsss::indexed_substring<IndexType>* strings,
+  std::size_t n, const std::size_t depth) {
+
+  if (n == 0) { return; }
+
+  dsss::indexed_substring<IndexType>* insert_pos = nullptr;
+
+  for (auto* cmp_pos = strings + 1; --n > 0; ++cmp_pos) {
+    const auto insert_str = *cmp_pos;
+    for (insert_pos = cmp_pos; insert_pos > strings; --insert_pos) {
+      const auto& s = *(insert_pos - 1);
+      std::size_t d = depth;
+      for (; s[d] == insert_str[d] && s[d] != 0; ++d) { }
+      if (s[d] <= insert_str[d]) {
+        break;
+      }
+      *insert_pos = *(insert_pos - 1);
+    }
+    *insert_pos = insert_str;
+  }
+}
+
 } // namespace dsss
 
 /******************************************************************************/
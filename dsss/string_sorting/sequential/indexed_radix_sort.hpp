@@ -78,6 +78,55 @@ static inline void msd_CE0(dsss::indexed_string_set<IndexType>& strings) {
   msd_CE0(strings.strings(), strings.size());
 }
 
+// Variant for substrings that are not 0-terminated, see indexed_substring
+template <typename IndexType,
+          std::size_t InssortThreshold = g_inssort_threshold>
+static inline void msd_CE0(dsss::indexed_substring<IndexType>* strings,
+  dsss::indexed_substring<IndexType>* sorted, const std::size_t n,
+  const std::size_t depth) {
+
+  if (n == 0) { return; }
+
+  if (n < InssortThreshold) {
+    dsss::inssort(strings, n, depth);
+    return;
+  }
+
+  constexpr std::size_t max_char =
+    std::numeric_limits<dsss::char_type>::max() + 1;
+  std::array<std::size_t, max_char> bucket_sizes = { 0 };
+  for (auto* cur_string = strings; cur_string < strings + n; ++cur_string) {
+    ++bucket_sizes[(*cur_string)[depth]];
+  }
+
+  std::array<dsss::indexed_substring<IndexType>*, max_char> buckets;
+  buckets[0] = sorted;
+  for (std::size_t i = 1; i < max_char; ++i) {
+    buckets[i] = buckets[i - 1] + bucket_sizes[i - 1];
+  }
+  for (auto* cur_string = strings; cur_string < strings + n; ++cur_string) {
+    *(buckets[(*cur_string)[depth]]++) = *cur_string;
+  }
+  dsss::drop_me(std::move(buckets));
+  std::copy_n(sorted, n, strings);
+
+  auto* bucket_border = strings + bucket_sizes[0];
+  for (std::size_t i = 1; i < max_char; ++i) {
+    if (bucket_sizes[i] > 0) {
+      msd_CE0(bucket_border, sorted, bucket_sizes[i], depth + 1);
+      bucket_border += bucket_sizes[i];
+    }
+  }
+}
+
+template <typename IndexType>
+static inline void msd_CE0(dsss::indexed_substring<IndexType>* strings,
+  const std::size_t n) {
+  auto* sorted = new dsss::indexed_substring<IndexType>[n];
+  msd_CE0<IndexType>(strings, sorted, n, 0);
+  delete [] sorted;
+}
+
 template <typename IndexType>
 static inline void msd_CE2_16bit_5(dsss::indexed_string<IndexType>* strings,
   std::size_t n, std::size_t depth, unsigned char* oracle,
@@ -8,21 +8,37 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "mpi/allgather.hpp"
 #include "mpi/allreduce.hpp"
 #include "util/string.hpp"
 
 namespace dsss::suffix_sorting {
 
-template <typename IndexType>
+// Counts the number of A-, A*-, B-, and B*-suffixes for each pair of the first
+// two characters. For byte alphabets, the counters are stored in dense arrays.
+// Larger alphabets use sparse counters, where only occurring pairs are stored.
+template <typename IndexType, typename CharType = dsss::char_type>
 class border_array {
 
+  static constexpr bool is_dense = (sizeof(CharType) == 1);
+
+  static_assert(sizeof(CharType) <= sizeof(std::uint32_t),
+                "Alphabets are limited to 32-bit characters.");
+
 public:
   border_array() {
-    std::fill(a_suffixes.begin(), a_suffixes.end(), IndexType(0));
-    std::fill(b_suffixes.begin(), b_suffixes.end(), IndexType(0));
+    if constexpr (is_dense) {
+      std::fill(a_suffixes.begin(), a_suffixes.end(), IndexType(0));
+      std::fill(b_suffixes.begin(), b_suffixes.end(), IndexType(0));
+    }
   }
 
   border_array(border_array&&) = default;
@@ -31,33 +47,128 @@ public:
   border_array(const border_array&) = delete;
   border_array& operator =(border_array&) = delete;
 
-  IndexType& a(const dsss::char_type first, const dsss::char_type second) {
-    return a_suffixes[first * max_char + second];
+  IndexType& a(const CharType first, const CharType second) {
+    return a_suffixes[key(first, second)];
+  }
+
+  IndexType& a_star(const CharType first, const CharType second) {
+    return a_suffixes[key(second, first)];
   }
 
-  IndexType& a_star(const dsss::char_type first, const dsss::char_type second) {
-    return a_suffixes[second * max_char + first];
+  IndexType& b(const CharType first, const CharType second) {
+    return b_suffixes[key(second, first)];
   }
 
-  IndexType& b(const dsss::char_type first, const dsss::char_type second) {
-    return b_suffixes[second * max_char + first];
+  IndexType& b_star(const CharType first, const CharType second) {
+    return b_suffixes[key(first, second)];
   }
 
-  IndexType& b_star(const dsss::char_type first, const dsss::char_type second) {
-    return b_suffixes[first * max_char + second];
+  // Adds the counters of another border array (e.g., of another part of the
+  // local text) to this one.
+  border_array& operator +=(border_array const& other) {
+    if constexpr (is_dense) {
+      for (size_t i = 0; i < a_suffixes.size(); ++i) {
+        a_suffixes[i] += other.a_suffixes[i];
+        b_suffixes[i] += other.b_suffixes[i];
+      }
+    } else {
+      for (const auto& counter : other.a_suffixes) {
+        a_suffixes[counter.first] += counter.second;
+      }
+      for (const auto& counter : other.b_suffixes) {
+        b_suffixes[counter.first] += counter.second;
+      }
+    }
+    return *this;
   }
 
   void communicate() {
-    a_suffixes = dsss::mpi::allreduce_sum(a_suffixes);
-    b_suffixes = dsss::mpi::allreduce_sum(b_suffixes);
+    if constexpr (is_dense) {
+      a_suffixes = dsss::mpi::allreduce_sum(a_suffixes);
+      b_suffixes = dsss::mpi::allreduce_sum(b_suffixes);
+    } else {
+      communicate_sparse(a_suffixes);
+      communicate_sparse(b_suffixes);
+    }
+  }
+
+  // Returns all pairs (first, second) of characters in lexicographical order,
+  // for which at least one of the counters is not zero.
+  std::vector<std::pair<CharType, CharType>> occurring_pairs() const {
+    std::vector<std::pair<CharType, CharType>> result;
+    if constexpr (is_dense) {
+      for (size_t c0 = 0; c0 < max_char; ++c0) {
+        for (size_t c1 = 0; c1 < max_char; ++c1) {
+          if ((c0 >= c1 && a_suffixes[(c0 * max_char) + c1] > 0) ||
+              (c0 > c1 && a_suffixes[(c1 * max_char) + c0] > 0) ||
+              (c0 <= c1 && b_suffixes[(c1 * max_char) + c0] > 0) ||
+              (c0 < c1 && b_suffixes[(c0 * max_char) + c1] > 0)) {
+            result.emplace_back(CharType(c0), CharType(c1));
+          }
+        }
+      }
+    } else {
+      // The first character of A-suffixes is not smaller than the second one,
+      // the first character of B-suffixes is not larger than the second one.
+      for (const auto& counter : a_suffixes) {
+        if (counter.second > 0) {
+          auto [ x, y ] = chars(counter.first);
+          result.emplace_back(std::max(x, y), std::min(x, y));
+        }
+      }
+      for (const auto& counter : b_suffixes) {
+        if (counter.second > 0) {
+          auto [ x, y ] = chars(counter.first);
+          result.emplace_back(std::min(x, y), std::max(x, y));
+        }
+      }
+      std::sort(result.begin(), result.end());
+      result.erase(std::unique(result.begin(), result.end()), result.end());
+    }
+    return result;
   }
 
 private:
   static constexpr size_t max_char =
     2 + std::numeric_limits<dsss::char_type>::max();
 
-  std::array<IndexType, max_char * max_char> a_suffixes;
-  std::array<IndexType, max_char * max_char> b_suffixes;
+  struct key_count {
+    std::uint64_t key;
+    IndexType count;
+  };
+
+  using counters = std::conditional_t<is_dense,
+    std::array<IndexType, max_char * max_char>,
+    std::unordered_map<std::uint64_t, IndexType>>;
+
+  static inline std::uint64_t key(const CharType first,
+                                  const CharType second) {
+    if constexpr (is_dense) {
+      return (size_t(first) * max_char) + size_t(second);
+    } else {
+      return (std::uint64_t(first) << 32) | std::uint64_t(second);
+    }
+  }
+
+  static inline std::pair<CharType, CharType> chars(const std::uint64_t key) {
+    return { CharType(key >> 32), CharType(key & 0xFFFFFFFF) };
+  }
+
+  static void communicate_sparse(counters& local_counters) {
+    std::vector<key_count> local_counts;
+    local_counts.reserve(local_counters.size());
+    for (const auto& counter : local_counters) {
+      local_counts.push_back(key_count { counter.first, counter.second });
+    }
+    auto global_counts = dsss::mpi::allgatherv(local_counts);
+    local_counters.clear();
+    for (const auto& kc : global_counts) {
+      local_counters[kc.key] += kc.count;
+    }
+  }
+
+  counters a_suffixes;
+  counters b_suffixes;
 
 }; // class border_array
 
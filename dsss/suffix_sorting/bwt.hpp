@@ -0,0 +1,58 @@
+/*******************************************************************************
+ * suffix_sorting/bwt.hpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <tuple>
+#include <vector>
+
+#include "mpi/allreduce.hpp"
+#include "mpi/distribute_data.hpp"
+#include "mpi/environment.hpp"
+#include "mpi/requestable_array.hpp"
+#include "mpi/scan.hpp"
+#include "util/string.hpp"
+
+namespace dsss::suffix_sorting {
+
+// Computes the BWT with BWT[i] = T[SA[i] - 1] (and T[n - 1] if SA[i] = 0)
+// using one request for all preceding characters. The BWT has the same
+// distribution as the SA. The second value is the primary index, i.e., the
+// position i with SA[i] = 0.
+template <typename IndexType>
+std::tuple<std::vector<dsss::char_type>, size_t> bwt(
+  std::vector<IndexType>& sa, std::vector<dsss::char_type>& local_text,
+  dsss::mpi::environment env = dsss::mpi::environment()) {
+
+  size_t total_size = local_text.size();
+  total_size = dsss::mpi::allreduce_sum(total_size, env);
+  local_text = dsss::mpi::distribute_data(local_text, env);
+  dsss::mpi::requestable_array req_text(local_text, total_size, env);
+
+  size_t local_size = sa.size();
+  const size_t offset = dsss::mpi::ex_prefix_sum(local_size, env);
+
+  size_t primary_index = 0;
+  std::vector<IndexType> req_pos;
+  req_pos.reserve(local_size);
+  for (size_t i = 0; i < local_size; ++i) {
+    if (sa[i] > IndexType(0)) {
+      req_pos.push_back(sa[i] - IndexType(1));
+    } else {
+      req_pos.push_back(IndexType(total_size - 1));
+      primary_index = offset + i;
+    }
+  }
+  primary_index = dsss::mpi::allreduce_sum(primary_index, env);
+
+  return std::make_tuple(req_text.request2(req_pos), primary_index);
+}
+
+} // namespace dsss::suffix_sorting
+
+/******************************************************************************/
@@ -10,14 +10,21 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <iterator>
+#include <limits>
 #include <tuple>
 #include <vector>
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 #include "mpi/allgather.hpp"
 #include "mpi/environment.hpp"
 #include "mpi/shift.hpp"
 #include "suffix_sorting/border_array.hpp"
 #include "util/indexed_string_set.hpp"
+#include "util/indexed_substring_set.hpp"
 #include "util/macros.hpp"
 #include "util/string.hpp"
 #include "util/string_set.hpp"
@@ -73,18 +80,52 @@ static std::tuple<dsss::string_set, border_array<size_t>>
     string_set(std::move(raw_substrings)), std::move(b_array));
 }
 
-template <typename IndexType>
-static std::tuple<dsss::indexed_string_set<IndexType>, border_array<size_t>>
-  idx_b_star_substrings_local(std::vector<dsss::char_type> const& input_string) {
+// The B*-substrings are sorted as (zero-terminated) byte strings. Characters
+// of larger alphabets are encoded using a fixed number of base-255 digits,
+// each shifted by one. This preserves the order and avoids zero bytes.
+template <typename CharType>
+static constexpr size_t encoded_char_length() {
+  size_t length = 1;
+  for (std::uint64_t max = 254; max < std::numeric_limits<CharType>::max();
+       max = (max * 255) + 254) {
+    ++length;
+  }
+  return length;
+}
+
+template <typename CharType, typename Iterator>
+static inline void encode_substring(Iterator begin, const size_t length,
+  std::vector<dsss::char_type>& raw_substrings) {
+
+  if constexpr (sizeof(CharType) == sizeof(dsss::char_type)) {
+    std::copy_n(begin, length, std::back_inserter(raw_substrings));
+  } else {
+    constexpr size_t char_length = encoded_char_length<CharType>();
+    for (size_t i = 0; i < length; ++i, ++begin) {
+      std::uint64_t c = *begin;
+      const size_t end = raw_substrings.size() + char_length;
+      raw_substrings.resize(end);
+      for (size_t j = 1; j <= char_length; ++j) {
+        raw_substrings[end - j] = dsss::char_type(1 + (c % 255));
+        c /= 255;
+      }
+    }
+  }
+}
+
+template <typename IndexType, typename CharType = dsss::char_type>
+static std::tuple<dsss::indexed_string_set<IndexType>,
+                  border_array<size_t, CharType>>
+  idx_b_star_substrings_local(std::vector<CharType> const& input_string) {
 
   auto raw_string = input_string;
-  border_array<size_t> b_array;
+  border_array<size_t, CharType> b_array;
   std::vector<IndexType> b_star_pos {
     static_cast<IndexType>(raw_string.size()) };
 
   for (std::int64_t i = raw_string.size() - 2; i >= 0;) {
-    dsss::char_type c0 = raw_string[i];
-    dsss::char_type c1 = raw_string[i + 1];
+    CharType c0 = raw_string[i];
+    CharType c1 = raw_string[i + 1];
     if (DSSS_LIKELY(i >= 0)) {
       ++b_array.a_star(c0, c1);
       --i;
@@ -105,13 +146,13 @@ static std::tuple<dsss::indexed_string_set<IndexType>, border_array<size_t>>
   std::reverse(b_star_pos.begin(), b_star_pos.end());
   // We want to look two characters to the right of each B*-substring, to this
   // end, we add two characters to the string (that we remove later on)
-  raw_string.emplace_back(dsss::char_type(0));
-  raw_string.emplace_back(dsss::char_type(0));
+  raw_string.emplace_back(CharType(0));
+  raw_string.emplace_back(CharType(0));
   std::vector<dsss::char_type> raw_substrings;
   for (size_t i = 0; i + 1 < b_star_pos.size(); ++i) {
-    std::copy_n(raw_string.begin() + b_star_pos[i],
-      b_star_pos[i + 1] - b_star_pos[i] + IndexType(2),
-      std::back_inserter(raw_substrings));
+    encode_substring<CharType>(raw_string.begin() + b_star_pos[i],
+      b_star_pos[i + 1] - b_star_pos[i] + IndexType(2), raw_substrings);
+    raw_substrings.emplace_back(dsss::char_type(0));
   }
   b_star_pos.pop_back();
   // Remove the characters added for a uniform construction of B*-substrings
@@ -123,6 +164,138 @@ static std::tuple<dsss::indexed_string_set<IndexType>, border_array<size_t>>
       std::move(b_star_pos)), std::move(b_array));
 }
 
+// Returns the leftmost B*-position i within the first length characters of
+// prefix + suffix, such that the B*-substring starting at i also ends there,
+// i.e., T[i] < T[i + 1] = ... = T[j] > T[j + 1] with j + 1 < length. This is
+// the position that the PE whose slice starts with these characters shifts to
+// its left neighbor. Returns -1 if there is no such position.
+template <typename CharType>
+static std::int64_t leftmost_b_star(std::vector<CharType> const& prefix,
+  std::vector<CharType> const& suffix, const size_t length) {
+
+  auto at = [&](const size_t i) {
+    return (i < prefix.size()) ? prefix[i] : suffix[i - prefix.size()];
+  };
+  for (size_t i = 0; i + 2 < length; ++i) {
+    if (at(i) < at(i + 1)) {
+      size_t j = i + 1;
+      while (j + 1 < length && at(j) == at(j + 1)) { ++j; }
+      if (j + 1 < length && at(j) > at(j + 1)) {
+        return static_cast<std::int64_t>(i);
+      }
+      i = j - 1;
+    }
+  }
+  return -1;
+}
+
+// Minimum number of suffixes that each thread classifies (see
+// classify_suffixes). Smaller values split small texts into multiple chunks,
+// too, e.g., for testing.
+inline std::int64_t min_classification_chunk_size = std::int64_t(1) << 16;
+
+// Classifies the suffixes starting at positions 0, ..., end - 1 of the text,
+// where the suffix starting at end is a B*-suffix, and counts them in b_array.
+// The B*-positions are appended to b_star_pos in decreasing order. Returns the
+// leftmost B*-position or, if there is none, the rightmost A-position (-1 if
+// there is no A-suffix either).
+//
+// The positions are split into one chunk per thread. Similar to the last PE,
+// only the last chunk knows the type of its last suffix. The types of the
+// other chunks' last runs of equal characters are resolved from right to left
+// (looking at the first run of the next chunk only) before all chunks are
+// classified independently.
+template <typename CharType, typename IndexType>
+static std::int64_t classify_suffixes(std::vector<CharType> const& text,
+  const std::int64_t end, border_array<size_t, CharType>& b_array,
+  std::vector<IndexType>& b_star_pos) {
+
+  std::int64_t chunks = 1;
+#if defined(_OPENMP)
+  chunks = std::max(std::int64_t(1), std::min<std::int64_t>(
+    omp_get_max_threads(), end / min_classification_chunk_size));
+#endif
+  auto chunk_begin = [&](const std::int64_t chunk) {
+    return (chunk * end) / chunks;
+  };
+
+  // Type of the first suffix of each chunk (-1 if it is the type of the first
+  // suffix of the next chunk). The suffix at end is a B-suffix.
+  std::vector<std::int8_t> is_b(chunks + 1, 1);
+  DSSS_OMP(parallel for)
+  for (std::int64_t chunk = 0; chunk < chunks; ++chunk) {
+    std::int64_t i = chunk_begin(chunk);
+    const std::int64_t chunk_end = chunk_begin(chunk + 1);
+    while (i < chunk_end && text[i] == text[i + 1]) { ++i; }
+    is_b[chunk] = (i < chunk_end) ?
+      std::int8_t(text[i] < text[i + 1]) : std::int8_t(-1);
+  }
+  for (std::int64_t chunk = chunks - 1; chunk >= 0; --chunk) {
+    if (is_b[chunk] < 0) { is_b[chunk] = is_b[chunk + 1]; }
+  }
+
+  // The first chunk is counted in b_array, all others in their own arrays
+  std::vector<border_array<size_t, CharType>> chunk_arrays(chunks - 1);
+  std::vector<std::vector<IndexType>> chunk_b_star_pos(chunks);
+  std::vector<std::int64_t> chunk_leftmost_b_star(chunks, -1);
+  std::vector<std::int64_t> chunk_rightmost_a(chunks, -1);
+  DSSS_OMP(parallel for)
+  for (std::int64_t chunk = 0; chunk < chunks; ++chunk) {
+    auto& counters = (chunk == 0) ? b_array : chunk_arrays[chunk - 1];
+    auto& positions = chunk_b_star_pos[chunk];
+    bool next_is_b = is_b[chunk + 1];
+    for (std::int64_t i = chunk_begin(chunk + 1) - 1;
+         i >= chunk_begin(chunk); --i) {
+      const CharType c0 = text[i];
+      const CharType c1 = text[i + 1];
+      const bool cur_is_b = (c0 < c1) || (c0 == c1 && next_is_b);
+      if (cur_is_b) {
+        if (next_is_b) {
+          ++counters.b(c0, c1);
+        } else {
+          ++counters.b_star(c0, c1);
+          positions.emplace_back(i);
+        }
+      } else {
+        if (next_is_b) {
+          ++counters.a_star(c0, c1);
+        } else {
+          ++counters.a(c0, c1);
+        }
+        if (chunk_rightmost_a[chunk] < 0) { chunk_rightmost_a[chunk] = i; }
+      }
+      next_is_b = cur_is_b;
+    }
+    if (!positions.empty()) {
+      chunk_leftmost_b_star[chunk] = positions.back();
+    }
+  }
+  for (auto const& counters : chunk_arrays) { b_array += counters; }
+
+  // The chunks' B*-positions are written (from right to left) behind the
+  // already known B*-positions, starting at the prefix sums of their numbers
+  std::vector<size_t> offsets(chunks + 1, b_star_pos.size());
+  for (std::int64_t chunk = chunks - 1; chunk >= 0; --chunk) {
+    offsets[chunk] = offsets[chunk + 1] + chunk_b_star_pos[chunk].size();
+  }
+  b_star_pos.resize(offsets[0]);
+  DSSS_OMP(parallel for)
+  for (std::int64_t chunk = 0; chunk < chunks; ++chunk) {
+    std::copy(chunk_b_star_pos[chunk].begin(), chunk_b_star_pos[chunk].end(),
+      b_star_pos.begin() + offsets[chunk + 1]);
+  }
+
+  for (std::int64_t chunk = 0; chunk < chunks; ++chunk) {
+    if (chunk_leftmost_b_star[chunk] >= 0) {
+      return chunk_leftmost_b_star[chunk];
+    }
+  }
+  for (std::int64_t chunk = chunks - 1; chunk >= 0; --chunk) {
+    if (chunk_rightmost_a[chunk] >= 0) { return chunk_rightmost_a[chunk]; }
+  }
+  return -1;
+}
+
 template <typename IndexType>
 static std::tuple<dsss::string_set, border_array<size_t>>
   b_star_substrings(dsss::distributed_string const& distributed_raw_string,
@@ -135,6 +308,7 @@ static std::tuple<dsss::string_set, border_array<size_t>>
   }
 
   auto raw_string = distributed_raw_string.string;
+  auto const& halo = distributed_raw_string.halo;
   // This is the position of the first B*-suffix on the PE that we can identify
   // with only the local string. For all PEs except of the last one, there may
   // be another B*-suffix preceding this one.
@@ -165,38 +339,24 @@ static std::tuple<dsss::string_set, border_array<size_t>>
     first_b_star = pos;
     ++b_array.b_star(c0, c1);
     b_star_pos.emplace_back(first_b_star);
-    --pos;
-  }
-  // Make sure that the position (pos) is at an A-suffix
-  while (pos >= 0 && (c0 = raw_string[pos]) <= (c1 = raw_string[pos + 1])) {
-    ++b_array.b(c0, c1);
-    --pos;
   }
   // Identify all B*-substrings and also set pos to position of the leftmost one
-  for (std::int64_t i = pos; i >= 0;) {
-    if (i >= 0 && (c0 = raw_string[i]) >= (c1 = raw_string[i + 1])) {
-      ++b_array.a_star(c0, c1);
-      --i; // We know that this has to be an A*-suffix
-    }
-    while (i >= 0 && (c0 = raw_string[i]) >= (c1 = raw_string[i + 1])) {
-      ++b_array.a(c0, c1);
-      --i;
-    }
-    if (DSSS_LIKELY(i >= 0)) {
-      ++b_array.b_star(c0, c1);
-      b_star_pos.emplace_back(pos = i); // set pos to the B*-position
-      --i;
-      while (i >= 0 && (c0 = raw_string[i]) <= (c1 = raw_string[i + 1])) {
-        ++b_array.b(c0, c1);
-        --i;
-      }
-    }
-  }
+  const bool has_first_b_star = !b_star_pos.empty();
+  pos = classify_suffixes(raw_string, first_b_star, b_array, b_star_pos);
+  if (has_first_b_star && b_star_pos.size() == 1) { pos = first_b_star; }
   std::reverse(std::begin(b_star_pos), std::end(b_star_pos));
 
   // Next, we shift left the pos-th prefix of the local text,
-  // i.e., T[0..pos + 2]
-  auto received_chars = dsss::mpi::shift_left(raw_string.data(), pos + 2, env);
+  // i.e., T[0..pos + 2], unless the left neighbor finds it in its halo. Both
+  // neighbors look at the same characters, hence, they agree on this.
+  const std::int64_t halo_pos = leftmost_b_star(halo,
+    std::vector<dsss::char_type>(), halo.size());
+  const bool send = leftmost_b_star(raw_string, halo, halo.size()) < 0;
+  auto received_chars = dsss::mpi::shift_left_if(raw_string.data(), pos + 2,
+    send, halo_pos < 0, env);
+  if (halo_pos >= 0) {
+    received_chars.assign(halo.begin(), halo.begin() + halo_pos + 2);
+  }
 
   if (env.rank() > 0) {
     // We delete the send symbols (minus the B*-position) from the local string
@@ -271,24 +431,42 @@ static std::tuple<dsss::string_set, border_array<size_t>>
     std::move(b_array));
 }
 
-template <typename IndexType>
-static std::tuple<dsss::indexed_string_set<IndexType>, border_array<size_t>>
-  idx_b_star_substrings(dsss::distributed_string const& distributed_raw_string,
-    dsss::mpi::environment env = dsss::mpi::environment()) {
+// Result of the classification of the local text. The B*-substrings start at
+// the B*-positions and end two characters after the next B*-position. The last
+// B*-position is not the start of a B*-substring. All positions are relative
+// to the local text. B*-substrings that end after the local text (on the next
+// PE) are contained in the tail.
+template <typename IndexType, typename CharType>
+struct b_star_classification {
+  std::vector<IndexType> b_star_pos;
+  border_array<size_t, CharType> b_array;
+  // Characters of the local text starting at tail_begin followed by the
+  // characters received from the next PE
+  std::vector<CharType> tail;
+  size_t tail_begin;
+
+  inline size_t length(const size_t i) const {
+    return b_star_pos[i + 1] - b_star_pos[i] + IndexType(2);
+  }
+}; // struct b_star_classification
 
-  border_array<size_t> b_array;
+template <typename IndexType, typename CharType>
+static b_star_classification<IndexType, CharType>
+  classify_b_star_substrings(std::vector<CharType> const& local_string,
+    std::vector<CharType> const& halo,
+    dsss::mpi::environment env = dsss::mpi::environment()) {
 
-  if (env.size() == 1) {
-    return idx_b_star_substrings_local<IndexType>(distributed_raw_string.string);
-  }
+  border_array<size_t, CharType> b_array;
 
-  auto raw_string = distributed_raw_string.string;
+  // The local text is not modified (or copied). The characters received from
+  // the next PE are accessed as if they were appended to it.
+  auto const& raw_string = local_string;
   // This is the position of the first B*-suffix on the PE that we can identify
   // with only the local string. For all PEs except of the last one, there may
   // be another B*-suffix preceding this one.
   std::int64_t pos = raw_string.size() - 2;
-  dsss::char_type c0;
-  dsss::char_type c1;
+  CharType c0;
+  CharType c1;
   if (env.rank() + 1 < env.size()) {
     // The type of the equal chars depends on the unknown type in the next PE
     while (pos >= 0 && (c0 = raw_string[pos]) <= (c1 = raw_string[pos + 1])) {
@@ -300,7 +478,7 @@ static std::tuple<dsss::indexed_string_set<IndexType>, border_array<size_t>>
     }
   } else {
     // On the last PE, we know that the last suffix has type A
-    ++b_array.a_star(raw_string[pos + 1], dsss::char_type(0));
+    ++b_array.a_star(raw_string[pos + 1], CharType(0));
     while (pos >= 0 && (c0 = raw_string[pos]) >= (c1 = raw_string[pos + 1])) {
       ++b_array.a(c0, c1);
       --pos;
@@ -309,117 +487,206 @@ static std::tuple<dsss::indexed_string_set<IndexType>, border_array<size_t>>
   std::vector<IndexType> b_star_pos;
 
   std::int64_t first_b_star = 0;
+  // If there is no B*-suffix in the local string, the suffixes are counted
+  // below, including the first one.
+  std::int64_t counted_end = -1;
   if (pos >= 0) {
     first_b_star = pos;
+    counted_end = pos;
     ++b_array.b_star(c0, c1);
     b_star_pos.emplace_back(first_b_star);
-    --pos;
-  }
-  // Make sure that the position (pos) is at an A-suffix
-  while (pos >= 0 && (c0 = raw_string[pos]) <= (c1 = raw_string[pos + 1])) {
-    ++b_array.b(c0, c1);
-    --pos;
   }
   // Identify all B*-substrings and also set pos to position of the leftmost one
-  for (std::int64_t i = pos; i >= 0;) {
-    if (i >= 0 && (c0 = raw_string[i]) >= (c1 = raw_string[i + 1])) {
-      ++b_array.a_star(c0, c1);
-      --i; // We know that this has to be an A*-suffix
-    }
-    while (i >= 0 && (c0 = raw_string[i]) >= (c1 = raw_string[i + 1])) {
-      ++b_array.a(c0, c1);
-      --i;
-    }
-    if (DSSS_LIKELY(i >= 0)) {
-      ++b_array.b_star(c0, c1);
-      b_star_pos.emplace_back(pos = i); // set pos to the B*-position
-      --i;
-      while (i >= 0 && (c0 = raw_string[i]) <= (c1 = raw_string[i + 1])) {
-        ++b_array.b(c0, c1);
-        --i;
-      }
-    }
-  }
+  pos = classify_suffixes(raw_string, first_b_star, b_array, b_star_pos);
+  if (counted_end >= 0 && b_star_pos.size() == 1) { pos = first_b_star; }
   std::reverse(std::begin(b_star_pos), std::end(b_star_pos));
 
   // Next, we shift left the pos-th prefix of the local text,
-  // i.e., T[0..pos + 2]
-  auto received_chars = dsss::mpi::shift_left(raw_string.data(), pos + 2, env);
-
-  if (env.rank() > 0) {
-    // We delete the send symbols (minus the B*-position) from the local string
-    // to avoid data duplication ...
-    raw_string.erase(raw_string.begin(), raw_string.begin() + pos);
-    for (auto& bs_pos : b_star_pos) { bs_pos -= pos; }
-    first_b_star -= pos;
+  // i.e., T[0..pos + 2], unless the left neighbor finds it in its halo. Both
+  // neighbors look at the same characters, hence, they agree on this.
+  const std::int64_t halo_pos = leftmost_b_star(halo,
+    std::vector<CharType>(), halo.size());
+  const bool send = leftmost_b_star(raw_string, halo, halo.size()) < 0;
+  auto received_chars = dsss::mpi::shift_left_if(raw_string.data(), pos + 2,
+    send, halo_pos < 0, env);
+  if (halo_pos >= 0) {
+    received_chars.assign(halo.begin(), halo.begin() + halo_pos + 2);
   }
+  // The send symbols (minus the B*-position) belong to the previous PE, i.e.,
+  // no B*-substring of this PE starts before first_b_star.
+  auto at = [&](const size_t i) {
+    return (i < raw_string.size()) ?
+      raw_string[i] : received_chars[i - raw_string.size()];
+  };
+  const size_t raw_size = raw_string.size() + received_chars.size();
   if (env.rank() + 1 < env.size()) {
-    const size_t rightoffset = received_chars.size(); 
-    // ... we also append the send data to the raw_string
-    std::move(received_chars.begin(), received_chars.end(),
-      std::back_inserter(raw_string));
     // There is at most one additional B*-substring that needs to be added to
     // the end of our list.
-    std::int64_t bs = raw_string.size() - 2;
+    std::int64_t bs = raw_size - 2;
+    const std::int64_t local_size = raw_string.size();
     //Since the last character corresponds to a B*-suffix, first B-suffixes...
-    while (bs > first_b_star &&
-      (c0 = raw_string[bs]) <= (c1 = raw_string[bs + 1])) {
-      if (bs + rightoffset < raw_string.size()) { ++b_array.b(c0, c1); }
+    while (bs > counted_end && (c0 = at(bs)) <= (c1 = at(bs + 1))) {
+      if (bs < local_size) { ++b_array.b(c0, c1); }
       --bs;
     }
     // ... then A-suffixes ...
-    if (bs > first_b_star) {
-      if (bs + rightoffset < raw_string.size()) { ++b_array.a_star(c0, c1); }
+    if (bs > counted_end) {
+      if (bs < local_size) { ++b_array.a_star(c0, c1); }
       --bs;
     }
-    while (bs > first_b_star &&
-      (c0 = raw_string[bs]) >= (c1 = raw_string[bs + 1])) {
-      if (bs + rightoffset < raw_string.size()) { ++b_array.a(c0, c1); }
+    while (bs > counted_end && (c0 = at(bs)) >= (c1 = at(bs + 1))) {
+      if (bs < local_size) { ++b_array.a(c0, c1); }
       --bs;
     }
     // ... then we maybe have found the last B*-suffix at this PE
-    if (bs > first_b_star) {
-      if (bs + rightoffset < raw_string.size()) { ++b_array.b_star(c0, c1); }
+    if (bs > counted_end) {
+      if (bs < local_size) { ++b_array.b_star(c0, c1); }
       b_star_pos.emplace_back(bs);
       bs--;
     }
     // ... then we count the rest of the B- and then A-suffixes
-    while (bs > first_b_star &&
-      (c0 = raw_string[bs]) <= (c1 = raw_string[bs + 1])) {
-      if (bs + rightoffset < raw_string.size()) { ++b_array.b(c0, c1); }
+    while (bs > counted_end && (c0 = at(bs)) <= (c1 = at(bs + 1))) {
+      if (bs < local_size) { ++b_array.b(c0, c1); }
       --bs;
     }
-    if (bs-- > first_b_star) {  ++b_array.a_star(c0, c1); }
-    while (bs > first_b_star &&
-      (c0 = raw_string[bs]) >= (c1 = raw_string[bs + 1])) {
-      if (bs + rightoffset < raw_string.size()) { ++b_array.a(c0, c1); }
+    if (bs-- > counted_end) {  ++b_array.a_star(c0, c1); }
+    while (bs > counted_end && (c0 = at(bs)) >= (c1 = at(bs + 1))) {
+      if (bs < local_size) { ++b_array.a(c0, c1); }
       --bs;
     }
   }
 
-  b_star_pos.emplace_back(raw_string.size() - 2);
+  b_star_pos.emplace_back(raw_size - 2);
+
+  b_array.communicate();
+
+  b_star_classification<IndexType, CharType> result {
+    std::move(b_star_pos), std::move(b_array), { }, raw_string.size() };
+  // Only the last B*-substrings can end after the local text
+  for (size_t i = result.b_star_pos.size() - 1; i > 0; --i) {
+    if (result.b_star_pos[i - 1] + result.length(i - 1) <=
+        raw_string.size()) {
+      break;
+    }
+    result.tail_begin = std::min<size_t>(result.tail_begin,
+      result.b_star_pos[i - 1]);
+  }
+  for (size_t i = result.tail_begin; i < raw_size; ++i) {
+    result.tail.emplace_back(at(i));
+  }
+  return result;
+}
+
+template <typename IndexType, typename CharType = dsss::char_type>
+static std::tuple<dsss::indexed_string_set<IndexType>,
+                  border_array<size_t, CharType>>
+  idx_b_star_substrings(std::vector<CharType> const& local_string,
+    const size_t local_offset, std::vector<CharType> const& halo,
+    dsss::mpi::environment env = dsss::mpi::environment()) {
+
+  auto classification = classify_b_star_substrings<IndexType, CharType>(
+    local_string, halo, env);
+  auto& b_star_pos = classification.b_star_pos;
 
   std::vector<dsss::char_type> raw_substrings;
   for (size_t i = 0; i + 1 < b_star_pos.size(); ++i) {
-    std::copy_n(raw_string.begin() + b_star_pos[i],
-      b_star_pos[i + 1] - b_star_pos[i] + IndexType(2),
-      std::back_inserter(raw_substrings));
+    const size_t position = b_star_pos[i];
+    if (position < classification.tail_begin) {
+      encode_substring<CharType>(local_string.begin() + position,
+        classification.length(i), raw_substrings);
+    } else {
+      encode_substring<CharType>(classification.tail.begin() +
+        (position - classification.tail_begin), classification.length(i),
+        raw_substrings);
+    }
     raw_substrings.emplace_back(dsss::char_type(0));
   }
 
-  // Delete the last three character, they are the first three characters on the
-  // next PE
-  raw_string.pop_back();
-  raw_string.pop_back();
-  raw_string.pop_back();
+  return std::forward_as_tuple(indexed_string_set<IndexType>(
+    std::move(raw_substrings), std::move(b_star_pos), IndexType(local_offset)),
+    std::move(classification.b_array));
+}
 
-  b_array.communicate();
+// Like idx_b_star_substring_views, but B*-substrings that are longer than
+// max_length (at least 3, 0 means unlimited) are split into pieces of length
+// max_length. Consecutive pieces overlap by two characters, just like
+// B*-substrings. Hence, equal pieces are followed by pieces starting at the
+// same distance and ties between pieces are resolved by ranking the string of
+// piece names, just like ties between B*-substrings. Only pieces for which
+// the third vector is non-zero start at a B*-position.
+template <typename IndexType>
+static std::tuple<dsss::indexed_substring_set<IndexType>,
+                  border_array<size_t>, std::vector<std::uint8_t>>
+  idx_b_star_substring_pieces(std::vector<dsss::char_type> const& local_string,
+    const size_t local_offset, std::vector<dsss::char_type> const& halo,
+    size_t max_length,
+    dsss::mpi::environment env = dsss::mpi::environment()) {
+
+  auto classification = classify_b_star_substrings<IndexType,
+    dsss::char_type>(local_string, halo, env);
+  auto& b_star_pos = classification.b_star_pos;
+
+  std::vector<IndexType> positions;
+  std::vector<IndexType> lengths;
+  std::vector<std::uint8_t> is_b_star;
+  if (max_length == 0) {
+    lengths.reserve(b_star_pos.size());
+    for (size_t i = 0; i + 1 < b_star_pos.size(); ++i) {
+      lengths.emplace_back(classification.length(i));
+    }
+    b_star_pos.pop_back();
+    positions = std::move(b_star_pos);
+  } else {
+    max_length = std::max(size_t(3), max_length);
+    for (size_t i = 0; i + 1 < b_star_pos.size(); ++i) {
+      size_t position = b_star_pos[i];
+      size_t length = classification.length(i);
+      // The last piece has at least three characters, i.e., it contains the
+      // next B*-position and the following character like the B*-substring.
+      while (length > max_length) {
+        is_b_star.emplace_back(std::uint8_t(position == b_star_pos[i]));
+        positions.emplace_back(IndexType(position));
+        lengths.emplace_back(IndexType(max_length));
+        position += max_length - 2;
+        length -= max_length - 2;
+      }
+      is_b_star.emplace_back(std::uint8_t(position == b_star_pos[i]));
+      positions.emplace_back(IndexType(position));
+      lengths.emplace_back(IndexType(length));
+    }
+  }
 
-  IndexType offset = (env.rank() == 0) ?
-    IndexType(0) : IndexType(distributed_raw_string.offset + pos);
+  return std::make_tuple(indexed_substring_set<IndexType>(
+    const_cast<dsss::string>(local_string.data()),
+    std::move(classification.tail), classification.tail_begin,
+    std::move(positions), std::move(lengths), IndexType(local_offset)),
+    std::move(classification.b_array), std::move(is_b_star));
+}
 
-  return std::forward_as_tuple(indexed_string_set<IndexType>(
-    std::move(raw_substrings), std::move(b_star_pos), offset), std::move(b_array));
+// Like idx_b_star_substrings, but the B*-substrings are not copied. Instead,
+// they point into the local text, which must not change until they have been
+// sorted (see sort_bs_substrings).
+template <typename IndexType>
+static std::tuple<dsss::indexed_substring_set<IndexType>,
+                  border_array<size_t>>
+  idx_b_star_substring_views(std::vector<dsss::char_type> const& local_string,
+    const size_t local_offset, std::vector<dsss::char_type> const& halo,
+    dsss::mpi::environment env = dsss::mpi::environment()) {
+
+  auto pieces = idx_b_star_substring_pieces<IndexType>(local_string,
+    local_offset, halo, 0, env);
+  return std::make_tuple(std::move(std::get<0>(pieces)),
+    std::move(std::get<1>(pieces)));
+}
+
+template <typename IndexType>
+static std::tuple<dsss::indexed_string_set<IndexType>, border_array<size_t>>
+  idx_b_star_substrings(dsss::distributed_string const& distributed_raw_string,
+    dsss::mpi::environment env = dsss::mpi::environment()) {
+
+  return idx_b_star_substrings<IndexType, dsss::char_type>(
+    distributed_raw_string.string, distributed_raw_string.offset,
+    distributed_raw_string.halo, env);
 }
 
 } // namespace dsss::suffix_sorting
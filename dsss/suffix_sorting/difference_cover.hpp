@@ -0,0 +1,408 @@
+/*******************************************************************************
+ * suffix_sorting/difference_cover.hpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "mpi/allgather.hpp"
+#include "mpi/allreduce.hpp"
+#include "mpi/alltoall.hpp"
+#include "mpi/distribute_data.hpp"
+#include "mpi/environment.hpp"
+#include "mpi/gather.hpp"
+#include "mpi/scan.hpp"
+#include "mpi/shift.hpp"
+#include "mpi/sort.hpp"
+#include "suffix_sorting/data_structs.hpp"
+#include "util/drop.hpp"
+#include "util/string.hpp"
+
+namespace dsss::suffix_sorting {
+
+// A difference cover D modulo X, i.e., for every 0 <= k < X there are two
+// samples i, j in D with (i - j) mod X = k.
+template <size_t X>
+struct difference_cover;
+
+template <>
+struct difference_cover<3> {
+  static constexpr std::array<size_t, 2> samples = { 0, 1 };
+}; // struct difference_cover<3>
+
+template <>
+struct difference_cover<7> {
+  static constexpr std::array<size_t, 3> samples = { 0, 1, 3 };
+}; // struct difference_cover<7>
+
+template <>
+struct difference_cover<13> {
+  static constexpr std::array<size_t, 4> samples = { 0, 1, 3, 9 };
+}; // struct difference_cover<13>
+
+template <>
+struct difference_cover<21> {
+  static constexpr std::array<size_t, 5> samples = { 0, 1, 6, 8, 18 };
+}; // struct difference_cover<21>
+
+template <size_t X>
+struct dcx_lookup {
+  static constexpr auto& cover = difference_cover<X>::samples;
+
+  // Index of the residue in the difference cover or -1 if it is not sampled.
+  std::array<int8_t, X> sample_class;
+  // Smallest l such that (a + l) mod X and (b + l) mod X are both sampled.
+  std::array<std::array<uint8_t, X>, X> offset;
+  // Position of the rank of suffix i + l in the rank tuple of suffix i, where
+  // a = i mod X.
+  std::array<std::array<uint8_t, X>, X> slot;
+
+  dcx_lookup() {
+    sample_class.fill(-1);
+    for (size_t k = 0; k < cover.size(); ++k) {
+      sample_class[cover[k]] = int8_t(k);
+    }
+    for (size_t a = 0; a < X; ++a) {
+      uint8_t cur_slot = 0;
+      for (size_t l = 0; l < X; ++l) {
+        slot[a][l] = cur_slot;
+        if (sample_class[(a + l) % X] >= 0) { ++cur_slot; }
+      }
+      for (size_t b = 0; b < X; ++b) {
+        size_t l = 0;
+        while (sample_class[(a + l) % X] < 0 ||
+               sample_class[(b + l) % X] < 0) { ++l; }
+        offset[a][b] = uint8_t(l);
+      }
+    }
+  }
+}; // struct dcx_lookup
+
+template <size_t X>
+inline const dcx_lookup<X> dcx_lookup_table;
+
+// The samples and suffixes are not packed, as the characters and indices can
+// be non-POD types (e.g., uint40), for which packing is ignored. Instead, the
+// wider fields come first, which avoids padding between the fields.
+template <typename CharType, typename IndexType, size_t X>
+struct dcx_sample {
+  IndexType index;
+  std::array<CharType, X> chars;
+};
+
+template <typename CharType, typename IndexType, size_t X>
+struct dcx_suffix {
+  std::array<IndexType, difference_cover<X>::samples.size()> ranks;
+  IndexType index;
+  std::array<CharType, X - 1> chars;
+  std::uint8_t mod;
+};
+
+// Sequential prefix doubling for inputs that are too small to be distributed.
+template <typename IndexType, typename CharType>
+std::vector<IndexType> dcx_base_case(const std::vector<CharType>& text) {
+  const size_t size = text.size();
+  std::vector<size_t> sa(size);
+  std::iota(sa.begin(), sa.end(), 0);
+  std::vector<size_t> rank(size);
+  std::vector<size_t> new_rank(size);
+  for (size_t i = 0; i < size; ++i) { rank[i] = uint64_t(text[i]); }
+
+  for (size_t k = 1; size > 0; k <<= 1) {
+    auto key = [&](const size_t i) {
+      return std::make_pair(rank[i], i + k < size ? rank[i + k] + 1 : 0);
+    };
+    std::sort(sa.begin(), sa.end(), [&](const size_t a, const size_t b) {
+      return key(a) < key(b);
+    });
+    new_rank[sa[0]] = 0;
+    for (size_t i = 1; i < size; ++i) {
+      new_rank[sa[i]] = new_rank[sa[i - 1]] +
+        (key(sa[i - 1]) < key(sa[i]) ? 1 : 0);
+    }
+    std::swap(rank, new_rank);
+    if (rank[sa[size - 1]] + 1 == size) { break; }
+  }
+  return std::vector<IndexType>(sa.begin(), sa.end());
+}
+
+// Computes the suffix array of a distributed text using the difference cover
+// algorithm (DCX). All characters of the text must be greater than zero, as
+// zero is used as sentinel. The resulting suffix array is distributed
+// arbitrarily.
+template <typename IndexType, size_t X, typename CharType>
+std::vector<IndexType> dcx_sort(std::vector<CharType>& local_text,
+  dsss::mpi::environment env = dsss::mpi::environment()) {
+
+  using IR = index_rank<IndexType>;
+  using sample = dcx_sample<CharType, IndexType, X>;
+  using suffix = dcx_suffix<CharType, IndexType, X>;
+
+  constexpr auto& cover = difference_cover<X>::samples;
+  constexpr size_t cover_size = cover.size();
+  const auto& lookup = dcx_lookup_table<X>;
+
+  size_t local_size = local_text.size();
+  const size_t total_size = dsss::mpi::allreduce_sum(local_size, env);
+
+  // If the slices are to short to contain all characters required for the
+  // tuples, we solve the problem on a single PE.
+  if (total_size < 2 * X * size_t(env.size())) {
+    std::vector<CharType> text(env.rank() == 0 ? total_size : 0);
+    dsss::mpi::gatherv(local_text.data(), local_size, 0, text.data(), env);
+    if (env.rank() == 0) {
+      return dcx_base_case<IndexType>(text);
+    }
+    return std::vector<IndexType>();
+  }
+
+  local_text = dsss::mpi::distribute_data(local_text, env);
+  local_size = local_text.size();
+  const size_t slice_size = std::max<size_t>(1, total_size / env.size());
+  const size_t offset = dsss::mpi::ex_prefix_sum(local_size, env);
+  const bool is_last_pe = env.rank() + 1 == env.size();
+
+  std::vector<CharType> right_chars = dsss::mpi::shift_left(
+    local_text.data(), X, env);
+  if (!is_last_pe) {
+    std::copy(right_chars.begin(), right_chars.end(),
+      std::back_inserter(local_text));
+  } else {
+    local_text.resize(local_size + X, CharType(0));
+  }
+  right_chars.clear();
+  right_chars.shrink_to_fit();
+
+  // Sort the sample positions (including the empty suffix at position n) by
+  // their first X characters and name them.
+  std::vector<sample> samples;
+  for (size_t i = 0; i < local_size + (is_last_pe ? 1 : 0); ++i) {
+    if (lookup.sample_class[(offset + i) % X] < 0) { continue; }
+    sample s;
+    std::copy_n(local_text.begin() + i, X, s.chars.begin());
+    s.index = offset + i;
+    samples.emplace_back(s);
+  }
+  dsss::mpi::sort(samples, [](const sample& a, const sample& b) {
+      return a.chars < b.chars;
+    }, env);
+
+  struct last_sample {
+    std::array<CharType, X> chars;
+    bool valid;
+  };
+
+  const size_t sample_count = samples.size();
+  const size_t sample_offset = dsss::mpi::ex_prefix_sum(sample_count, env);
+  last_sample local_last;
+  local_last.valid = sample_count > 0;
+  if (local_last.valid) { local_last.chars = samples.back().chars; }
+  std::vector<last_sample> last_samples = dsss::mpi::allgather(local_last,
+                                                               env);
+  const last_sample* predecessor = nullptr;
+  for (int32_t rank = env.rank() - 1; rank >= 0 && !predecessor; --rank) {
+    if (last_samples[rank].valid) { predecessor = &last_samples[rank]; }
+  }
+
+  std::vector<IR> ranks;
+  ranks.reserve(sample_count);
+  bool all_unique = true;
+  size_t first_group = sample_count;
+  size_t group_start = 0;
+  for (size_t i = 0; i < sample_count; ++i) {
+    const bool new_group = (i > 0) ?
+      (samples[i - 1].chars != samples[i].chars) :
+      (predecessor == nullptr || predecessor->chars != samples[i].chars);
+    if (new_group) {
+      group_start = sample_offset + i;
+      first_group = std::min(first_group, i);
+    } else {
+      all_unique = false;
+    }
+    ranks.emplace_back(IndexType(samples[i].index), group_start + 1);
+  }
+  samples.clear();
+  samples.shrink_to_fit();
+
+  // Groups may span multiple PEs, hence, the first names must be corrected.
+  const size_t preceding_group = dsss::mpi::ex_prefix_max(
+    first_group < sample_count ? group_start : size_t(0), env);
+  for (size_t i = 0; i < first_group; ++i) {
+    ranks[i].rank = preceding_group + 1;
+  }
+  all_unique = dsss::mpi::allreduce_and(all_unique, env);
+
+  if (!all_unique) {
+    // Build the reduced string (names of samples ordered by their residue
+    // class and then by their position) and sort it recursively.
+    std::array<size_t, cover_size + 1> class_offset;
+    class_offset[0] = 0;
+    for (size_t k = 0; k < cover_size; ++k) {
+      class_offset[k + 1] = class_offset[k] + (total_size - cover[k]) / X + 1;
+    }
+    const size_t reduced_size = class_offset[cover_size];
+    const size_t reduced_slice = std::max<size_t>(1,
+      reduced_size / env.size());
+
+    auto get_target_rank = [&](const size_t pos) {
+      return std::min<size_t>(env.size() - 1, pos / reduced_slice);
+    };
+
+    std::vector<size_t> send_counts(env.size(), 0);
+    for (auto& ir : ranks) {
+      const size_t index = ir.index;
+      ir.index = class_offset[lookup.sample_class[index % X]] + index / X;
+      ++send_counts[get_target_rank(ir.index)];
+    }
+    std::vector<size_t> send_offsets(env.size(), 0);
+    for (int32_t i = 1; i < env.size(); ++i) {
+      send_offsets[i] = send_offsets[i - 1] + send_counts[i - 1];
+    }
+    std::vector<IR> send_data(ranks.size());
+    for (const auto& ir : ranks) {
+      send_data[send_offsets[get_target_rank(ir.index)]++] = ir;
+    }
+    ranks = dsss::mpi::alltoallv(send_data, send_counts, env);
+    send_data.clear();
+    send_data.shrink_to_fit();
+
+    std::sort(ranks.begin(), ranks.end(), [](const IR& a, const IR& b) {
+        return a.index < b.index;
+      });
+    std::vector<IndexType> reduced_text;
+    reduced_text.reserve(ranks.size());
+    for (const auto& ir : ranks) { reduced_text.emplace_back(IndexType(ir.rank)); }
+    ranks.clear();
+    ranks.shrink_to_fit();
+
+    std::vector<IndexType> reduced_sa =
+      dcx_sort<IndexType, X>(reduced_text, env);
+    reduced_text.clear();
+    reduced_text.shrink_to_fit();
+
+    size_t reduced_sa_size = reduced_sa.size();
+    const size_t rank_offset = dsss::mpi::ex_prefix_sum(reduced_sa_size, env);
+    ranks.reserve(reduced_sa_size);
+    for (size_t i = 0; i < reduced_sa_size; ++i) {
+      const size_t pos = reduced_sa[i];
+      const size_t cls = std::upper_bound(class_offset.begin(),
+        class_offset.end(), pos) - class_offset.begin() - 1;
+      ranks.emplace_back(cover[cls] + X * (pos - class_offset[cls]),
+                         rank_offset + i + 1);
+    }
+  }
+
+  // Send the ranks of the samples to the PEs containing the corresponding
+  // positions of the text. The ranks of the first X - 1 sample positions of
+  // a slice are also required by the preceding PE.
+  {
+    auto get_target_rank = [&](const size_t pos) {
+      return std::min<size_t>(env.size() - 1, pos / slice_size);
+    };
+
+    std::vector<size_t> send_counts(env.size(), 0);
+    for (const auto& ir : ranks) {
+      const size_t target = get_target_rank(ir.index);
+      ++send_counts[target];
+      if (target > 0 && ir.index < target * slice_size + X - 1) {
+        ++send_counts[target - 1];
+      }
+    }
+    std::vector<size_t> send_offsets(env.size(), 0);
+    for (int32_t i = 1; i < env.size(); ++i) {
+      send_offsets[i] = send_offsets[i - 1] + send_counts[i - 1];
+    }
+    std::vector<IR> send_data(send_offsets.back() + send_counts.back());
+    for (const auto& ir : ranks) {
+      const size_t target = get_target_rank(ir.index);
+      send_data[send_offsets[target]++] = ir;
+      if (target > 0 && ir.index < target * slice_size + X - 1) {
+        send_data[send_offsets[target - 1]++] = ir;
+      }
+    }
+    ranks = dsss::mpi::alltoallv(send_data, send_counts, env);
+  }
+
+  std::vector<IndexType> sample_ranks(local_size + X, IndexType(0));
+  for (const auto& ir : ranks) { sample_ranks[ir.index - offset] = ir.rank; }
+  ranks.clear();
+  ranks.shrink_to_fit();
+
+  // Compare each suffix by its first l characters and the rank of the sample
+  // at distance l, where l is given by the difference cover.
+  std::vector<suffix> suffixes;
+  suffixes.reserve(local_size);
+  for (size_t i = 0; i < local_size; ++i) {
+    suffix s;
+    s.index = offset + i;
+    s.mod = uint8_t((offset + i) % X);
+    std::copy_n(local_text.begin() + i, X - 1, s.chars.begin());
+    for (size_t l = 0, cur_slot = 0; l < X; ++l) {
+      if (lookup.sample_class[(s.mod + l) % X] >= 0) {
+        s.ranks[cur_slot++] = sample_ranks[i + l];
+      }
+    }
+    suffixes.emplace_back(s);
+  }
+  local_text.clear();
+  local_text.shrink_to_fit();
+  sample_ranks.clear();
+  sample_ranks.shrink_to_fit();
+
+  dsss::mpi::sort(suffixes, [](const suffix& a, const suffix& b) {
+      const auto& lookup = dcx_lookup_table<X>;
+      const size_t l = lookup.offset[a.mod][b.mod];
+      for (size_t i = 0; i < l; ++i) {
+        if (a.chars[i] != b.chars[i]) { return a.chars[i] < b.chars[i]; }
+      }
+      return a.ranks[lookup.slot[a.mod][l]] < b.ranks[lookup.slot[b.mod][l]];
+    }, env);
+
+  std::vector<IndexType> sa;
+  sa.reserve(suffixes.size());
+  for (const auto& s : suffixes) { sa.emplace_back(IndexType(s.index)); }
+  return sa;
+}
+
+template <typename IndexType, size_t X>
+std::vector<IndexType> dcx(dsss::distributed_string&& distributed_raw_string) {
+  dsss::mpi::environment env;
+
+  // Map the alphabet to [1, sigma], as zero is used as sentinel.
+  std::vector<dsss::char_type>& local_str = distributed_raw_string.string;
+  std::vector<size_t> char_histogram(256, 0);
+  for (const auto c : local_str) { ++char_histogram[c]; }
+  char_histogram = dsss::mpi::allreduce_sum(char_histogram, env);
+  std::vector<size_t> char_map(256, 0);
+  size_t new_alphabet_size = 1;
+  for (size_t i = 0; i < 256; ++i) {
+    if (char_histogram[i] != 0) { char_map[i] = new_alphabet_size++; }
+  }
+
+  if (new_alphabet_size <= 256) {
+    std::vector<dsss::char_type> text;
+    text.reserve(local_str.size());
+    for (const auto c : local_str) { text.emplace_back(char_map[c]); }
+    dsss::drop_me(std::move(distributed_raw_string));
+    return dcx_sort<IndexType, X>(text, env);
+  } else {
+    std::vector<std::uint16_t> text;
+    text.reserve(local_str.size());
+    for (const auto c : local_str) { text.emplace_back(char_map[c]); }
+    dsss::drop_me(std::move(distributed_raw_string));
+    return dcx_sort<IndexType, X>(text, env);
+  }
+}
+
+} // namespace dsss::suffix_sorting
+
+/******************************************************************************/
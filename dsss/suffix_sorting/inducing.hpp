@@ -1,5 +1,5 @@
 /*******************************************************************************
- * suffix_sorting/dsaca.hpp
+ * suffix_sorting/inducing.hpp
  *
  * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
  *
@@ -9,16 +9,26 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
+#include "mpi/allgather.hpp"
 #include "mpi/allreduce.hpp"
+#include "mpi/alltoall.hpp"
 #include "mpi/broadcast.hpp"
+#include "mpi/checkpoint.hpp"
 #include "mpi/environment.hpp"
 #include "mpi/gather.hpp"
 #include "mpi/induce.hpp"
 #include "mpi/requestable_array.hpp"
 #include "mpi/scan.hpp"
-#include "mpi/scatter.hpp"
 #include "mpi/sort.hpp"
 #include "mpi/shift.hpp"
 #include "mpi/zip.hpp"
@@ -27,8 +37,10 @@
 #include "string_sorting/sequential/indexed_radix_sort.hpp"
 #include "suffix_sorting/classification.hpp"
 #include "suffix_sorting/data_structs.hpp"
+#include "suffix_sorting/difference_cover.hpp"
 #include "suffix_sorting/prefix_doubling.hpp"
 #include "util/macros.hpp"
+#include "util/spill_vector.hpp"
 #include "util/string.hpp"
 
 namespace dsss::suffix_sorting {
@@ -46,79 +58,74 @@ inline void sort_bs_substrings(
 }
 
 template <typename IndexType>
-std::vector<IndexType> sort_bs_suffixes(
-  dsss::indexed_string_set<IndexType>& bs_substrings,
-  dsss::mpi::environment env = dsss::mpi::environment()) {
-
-  using IR = index_rank<IndexType>;
-  using IRR = index_rank_rank<IndexType>;
-  using IRS = index_rank_state<IndexType>;
-
-  size_t local_size = bs_substrings.size();
-
-  size_t offset = dsss::mpi::ex_prefix_sum(local_size);
-  IndexType cur_rank = IndexType(offset);
+inline dsss::indexed_string_set<IndexType> sort_bs_substrings(
+  dsss::indexed_substring_set<IndexType>& bs_substrings,
+  [[maybe_unused]] dsss::mpi::environment env = dsss::mpi::environment()) {
 
-  std::vector<IR> irs;
-  irs.reserve(local_size);
+  // Same as above, but the substrings point into the text. They are copied
+  // when they are exchanged and the result consists of 0-terminated strings.
+  return dsss::sample_sort::sample_sort<IndexType, dsss::msd_CE0<IndexType>,
+    bingmann::bingmann_msd_CE3>(bs_substrings);
+}
 
-  if (local_size > 0) {
-    irs.emplace_back(bs_substrings[0].index, cur_rank);
-  }
-  for (size_t i = 1; i < local_size; ++i) {
-    if (!dsss::string_eq(bs_substrings[i].string,
-                         bs_substrings[i - 1].string)) {
-      cur_rank = IndexType(offset + i);
+// Classifies the text and returns its (sorted, if sort is true) B*-substrings.
+// For byte alphabets, the B*-substrings are not copied until they are sorted
+// and longer B*-substrings are split into pieces of length max_length (unless
+// it is 0). The returned flags mark the pieces that start at a B*-position
+// (see idx_b_star_substring_pieces). They are empty if nothing was split.
+template <typename IndexType, typename CharType>
+inline std::tuple<dsss::indexed_string_set<IndexType>,
+                  border_array<size_t, CharType>, std::vector<std::uint8_t>>
+  sorted_bs_substrings(std::vector<CharType> const& local_text,
+    const size_t local_offset, std::vector<CharType> const& halo,
+    const bool sort, [[maybe_unused]] const size_t max_length = 0,
+    dsss::mpi::environment env = dsss::mpi::environment()) {
+
+  if constexpr (sizeof(CharType) == 1) {
+    auto [ bs_substrings, b_array, is_b_star ] =
+      idx_b_star_substring_pieces<IndexType>(local_text, local_offset, halo,
+        max_length, env);
+    dsss::indexed_string_set<IndexType> sorted_substrings;
+    if (sort) {
+      sorted_substrings = sort_bs_substrings(bs_substrings, env);
     }
-    irs.emplace_back(bs_substrings[i].index, cur_rank);
-  }
-
-  bool all_distinct = true;
-  for (size_t i = 1; i < irs.size(); ++i) {
-    all_distinct &= (irs[i].rank != irs[i - 1].rank);
-    if (!all_distinct) {
-      break;
+    return std::make_tuple(std::move(sorted_substrings), std::move(b_array),
+      std::move(is_b_star));
+  } else {
+    auto [ bs_substrings, b_array ] =
+      idx_b_star_substrings<IndexType, CharType>(local_text, local_offset,
+        halo, env);
+    if (sort) {
+      sort_bs_substrings(bs_substrings, env);
     }
+    return std::make_tuple(std::move(bs_substrings), std::move(b_array),
+      std::vector<std::uint8_t>());
   }
-  bool finished = dsss::mpi::allreduce_and(all_distinct, env);
-
-  std::vector<IndexType> bs_positions;
-  if (finished) {
-    // Everything is sorted before we have done anything    
-    bs_positions.reserve(local_size);
-    std::transform(irs.begin(), irs.end(), std::back_inserter(bs_positions),
-                   [](const IR& a) { return a.index; });
-    return bs_positions;
-  }
-
-  dsss::mpi::sort(irs, [](const IR& a, const IR& b) {
-                         return a.index < b.index; }, env);
+}
 
-  local_size = irs.size();
-  offset = dsss::mpi::ex_prefix_sum(local_size);
+// Computes the inverse suffix array of the reduced string using prefix
+// doubling. The index of each rank is its position in the reduced string.
+template <typename IndexType>
+std::vector<IndexType> rank_reduced_string(
+  std::vector<index_rank<IndexType>>& irs,
+  const doubling_config& doubling = doubling_config(),
+  dsss::mpi::environment env = dsss::mpi::environment()) {
 
-  bs_positions.reserve(local_size);
-  IndexType string_pos = IndexType(offset);
-  for (size_t i = 0; i < irs.size(); ++i) {
-    bs_positions.emplace_back(irs[i].index);
-    irs[i].index = ++string_pos;
-  }
+  using IR = index_rank<IndexType>;
+  using IRR = index_rank_rank<IndexType>;
+  using IRS = index_rank_state<IndexType>;
 
   size_t iteration = 0;
-  dsss::mpi::sort(irs, [iteration](const IR& a, const IR& b) {
-    IndexType mod_mask = (size_t(1) << iteration) - 1;
-    IndexType div_mask = ~mod_mask;
-
-    if ((a.index & mod_mask) == (b.index & mod_mask)) {
-      return (a.index & div_mask) < (b.index & div_mask);
-    } else {
-      return (a.index & mod_mask) < (b.index & mod_mask);
-    }
+  dsss::mpi::sort_by_key(irs, [iteration](const IR& x) {
+    const size_t mod_mask = (size_t(1) << iteration) - 1;
+    return std::make_tuple(size_t(x.index) & mod_mask,
+                           size_t(x.index) >> iteration);
   }, env);
 
-  local_size = irs.size();
-  offset = dsss::mpi::ex_prefix_sum(local_size, env);
-                              
+  size_t local_size = irs.size();
+  size_t offset = dsss::mpi::ex_prefix_sum(local_size, env);
+  size_t total_size = dsss::mpi::allreduce_sum(local_size, env);
+
   IR rightmost_ir = dsss::mpi::shift_left(irs.front(), env);
   if (env.rank() + 1 < env.size()) {
     irs.emplace_back(rightmost_ir);
@@ -134,7 +141,8 @@ std::vector<IndexType> sort_bs_suffixes(
     if (DSSS_LIKELY(irs[i].index + index_distance == irs[i + 1].index)) {
       second_rank = irs[i + 1].rank;
     }
-    irrs.emplace_back(irs[i].index, irs[i].rank, second_rank);
+    irrs.emplace_back(IndexType(irs[i].index),
+      IndexType(irs[i].rank), second_rank);
   }
 
   irs.clear();
@@ -148,13 +156,13 @@ std::vector<IndexType> sort_bs_suffixes(
   std::vector<IRS> irss;
   irss.reserve(local_size);
   offset = dsss::mpi::ex_prefix_sum(local_size, env) + 1;
-  cur_rank = offset;
-  irss.emplace_back(irrs[0].index, cur_rank, rank_state::NONE);
+  IndexType cur_rank = offset;
+  irss.emplace_back(IndexType(irrs[0].index), cur_rank, rank_state::NONE);
   for (size_t i = 1; i < local_size; ++i) {
     if (irrs[i - 1] != irrs[i]) {
       cur_rank = offset + i;
     }
-    irss.emplace_back(irrs[i].index, cur_rank, rank_state::NONE);
+    irss.emplace_back(IndexType(irrs[i].index), cur_rank, rank_state::NONE);
   }
   if (irss.size() == 1) {
     irss[0].state = rank_state::UNIQUE;
@@ -177,7 +185,180 @@ std::vector<IndexType> sort_bs_suffixes(
   irrs.shrink_to_fit();
 
   ++iteration;
-  auto part_isa = doubling_discarding<IndexType, true>(irss, iteration, env);
+  return doubling_discarding<IndexType, true>(irss, iteration, total_size,
+                                              doubling, env);
+}
+
+// Computes the inverse suffix array of the reduced string, i.e., the string
+// of B*-substring names (given in text order), recursively.
+template <typename IndexType>
+std::vector<IndexType> reduced_string_isa(std::vector<IndexType>& names,
+  dsss::mpi::environment env = dsss::mpi::environment()) {
+
+  using IR = index_rank<IndexType>;
+
+  std::vector<IndexType> reduced_sa = dcx_sort<IndexType, 3>(names, env);
+
+  auto irs = dsss::mpi::zip_with_index(reduced_sa,
+    [](const size_t rank, const IndexType pos) {
+      return IR { pos, IndexType(rank) };
+    }, env);
+  reduced_sa.clear();
+  reduced_sa.shrink_to_fit();
+
+  dsss::mpi::sort(irs, [](const IR& a, const IR& b) {
+    return a.index < b.index;
+  }, env);
+
+  std::vector<IndexType> isa;
+  isa.reserve(irs.size());
+  std::transform(irs.begin(), irs.end(), std::back_inserter(isa),
+    [](const IR& ir) { return ir.rank; });
+  return isa;
+}
+
+// Removes the ranked pieces of B*-substrings that do not start at a
+// B*-position. The pieces and their flags have to be given in text order and
+// the pieces have to be distributed like by distribute_data.
+template <typename IndexType>
+void drop_inner_pieces(std::vector<index_rank<IndexType>>& irs,
+  std::vector<std::uint8_t>& is_b_star,
+  dsss::mpi::environment env = dsss::mpi::environment()) {
+
+  is_b_star = dsss::mpi::distribute_data(is_b_star, env);
+  size_t b_star_count = 0;
+  for (size_t i = 0; i < irs.size(); ++i) {
+    if (is_b_star[i]) {
+      irs[b_star_count++] = irs[i];
+    }
+  }
+  irs.resize(b_star_count);
+}
+
+// The B*-substrings can also be pieces of B*-substrings, in which case
+// is_b_star marks the pieces starting at B*-positions in text order (see
+// idx_b_star_substring_pieces). Only the B*-suffixes are returned.
+template <typename IndexType>
+std::vector<IndexType> sort_bs_suffixes(
+  dsss::indexed_string_set<IndexType>& bs_substrings,
+  const bool recursive_ranking = false,
+  const doubling_config& doubling = doubling_config(),
+  std::vector<std::uint8_t> is_b_star = std::vector<std::uint8_t>(),
+  dsss::mpi::environment env = dsss::mpi::environment()) {
+
+  using IR = index_rank<IndexType>;
+
+  bool has_pieces = !is_b_star.empty();
+  has_pieces = dsss::mpi::allreduce_or(has_pieces, env);
+
+  size_t local_size = bs_substrings.size();
+
+  size_t offset = dsss::mpi::ex_prefix_sum(local_size);
+
+  // Equal B*-substrings can be split between PEs, hence the first name on
+  // this PE may be the last name of the closest non-empty PE to the left.
+  std::vector<dsss::char_type> last_string;
+  if (local_size > 0) {
+    dsss::string str = bs_substrings[local_size - 1].string;
+    std::copy_n(str, dsss::string_length(str) + 1,
+                std::back_inserter(last_string));
+  }
+  auto last_strings = dsss::mpi::allgather_strings(last_string, env);
+  auto local_sizes = dsss::mpi::allgather(local_size, env);
+  size_t non_empty_left = 0;
+  for (int32_t pe = 0; pe < env.rank(); ++pe) {
+    non_empty_left += (local_sizes[pe] > 0);
+  }
+
+  bool new_first_name = true;
+  size_t last_name = 0;
+  if (local_size > 0) {
+    new_first_name = (non_empty_left == 0) ||
+      !dsss::string_eq(last_strings[non_empty_left - 1],
+                       bs_substrings[0].string);
+    size_t last_name_start = 0;
+    for (size_t i = local_size - 1; i > 0; --i) {
+      if (!dsss::string_eq(bs_substrings[i].string,
+                           bs_substrings[i - 1].string)) {
+        last_name_start = i;
+        break;
+      }
+    }
+    if (last_name_start > 0 || new_first_name) {
+      last_name = offset + last_name_start;
+    }
+  }
+  const size_t prev_last_name = dsss::mpi::ex_prefix_max(last_name, env);
+  IndexType cur_rank = IndexType(new_first_name ? offset : prev_last_name);
+
+  std::vector<IR> irs;
+  irs.reserve(local_size);
+
+  if (local_size > 0) {
+    irs.emplace_back(bs_substrings[0].index, cur_rank);
+  }
+  for (size_t i = 1; i < local_size; ++i) {
+    if (!dsss::string_eq(bs_substrings[i].string,
+                         bs_substrings[i - 1].string)) {
+      cur_rank = IndexType(offset + i);
+    }
+    irs.emplace_back(bs_substrings[i].index, cur_rank);
+  }
+
+  bool all_distinct = new_first_name;
+  for (size_t i = 1; i < irs.size(); ++i) {
+    all_distinct &= (irs[i].rank != irs[i - 1].rank);
+    if (!all_distinct) {
+      break;
+    }
+  }
+  bool finished = dsss::mpi::allreduce_and(all_distinct, env);
+
+  std::vector<IndexType> bs_positions;
+  if (finished) {
+    // Everything is sorted before we have done anything    
+    if (has_pieces) {
+      dsss::mpi::balanced_sort(irs, [](const IR& a, const IR& b) {
+                                      return a.index < b.index; }, env);
+      drop_inner_pieces(irs, is_b_star, env);
+      dsss::mpi::sort(irs, [](const IR& a, const IR& b) {
+                             return a.rank < b.rank; }, env);
+    }
+    bs_positions.reserve(irs.size());
+    std::transform(irs.begin(), irs.end(), std::back_inserter(bs_positions),
+                   [](const IR& a) { return a.index; });
+    return bs_positions;
+  }
+
+  dsss::mpi::sort(irs, [](const IR& a, const IR& b) {
+                         return a.index < b.index; }, env);
+
+  local_size = irs.size();
+  offset = dsss::mpi::ex_prefix_sum(local_size);
+
+  bs_positions.reserve(local_size);
+  std::vector<IndexType> part_isa;
+  if (recursive_ranking) {
+    // The names of the B*-substrings in text order form the reduced string,
+    // whose suffix array is the order of the B*-suffixes. Zero is reserved as
+    // sentinel.
+    std::vector<IndexType> names;
+    names.reserve(local_size);
+    for (const auto& ir : irs) {
+      bs_positions.emplace_back(IndexType(ir.index));
+      names.emplace_back(ir.rank + IndexType(1));
+    }
+    irs.clear();
+    irs.shrink_to_fit();
+    part_isa = reduced_string_isa(names, env);
+  } else {
+    IndexType string_pos = IndexType(offset);
+    for (size_t i = 0; i < irs.size(); ++i) {
+      bs_positions.emplace_back(IndexType(irs[i].index));
+      irs[i].index = string_pos++;
+    }
+    part_isa = rank_reduced_string(irs, doubling, env);
+  }
   
   irs = dsss::mpi::zip(bs_positions, part_isa,
     [](const IndexType idx, const IndexType isa) {
@@ -190,6 +371,10 @@ std::vector<IndexType> sort_bs_suffixes(
   bs_positions.clear();
   bs_positions.shrink_to_fit();
 
+  if (has_pieces) {
+    drop_inner_pieces(irs, is_b_star, env);
+  }
+
   dsss::mpi::sort(irs, [](const IR& a, const IR& b) {
     return a.rank < b.rank;
   }, env);
@@ -231,170 +416,527 @@ inline size_t compute_local_size(size_t const global_size,
   return local_size;
 }
 
-template <typename IndexType>
-std::vector<IndexType> inducing(dsss::distributed_string&& distributed_input) {
+// Sorts the positions (stably) by the characters preceding them and returns
+// all characters that precede a position on any PE, together with the local
+// number of positions preceded by each of these characters.
+template <typename IndexType, typename CharType>
+std::tuple<std::vector<IndexType>, std::vector<CharType>, std::vector<size_t>>
+  group_by_char(std::vector<IndexType> const& positions,
+                std::vector<CharType> const& chars,
+                dsss::mpi::environment env = dsss::mpi::environment()) {
+
+  std::vector<IndexType> grouped_positions(positions.size());
+  std::vector<CharType> occurring_chars;
+  std::vector<size_t> local_counts;
+
+  if constexpr (sizeof(CharType) == 1) {
+    constexpr size_t max_char = std::numeric_limits<CharType>::max();
+
+    std::array<size_t, max_char + 1> borders;
+    std::array<size_t, max_char + 1> hist;
+    std::fill_n(borders.begin(), max_char + 1, 0);
+    std::fill_n(hist.begin(), max_char + 1, 0);
+    for (size_t i = 0; i < chars.size(); ++i) {
+      ++hist[chars[i]];
+    }
+    for (size_t i = 1; i < max_char + 1; ++i) {
+      borders[i] = borders[i - 1] + hist[i - 1];
+    }
+    for (size_t i = 0; i < chars.size(); ++i) {
+      grouped_positions[borders[chars[i]]++] = positions[i];
+    }
+
+    auto global_hist = dsss::mpi::allreduce_sum(hist, env);
+    for (size_t i = 0; i < max_char + 1; ++i) {
+      if (global_hist[i] > 0) {
+        occurring_chars.push_back(CharType(i));
+        local_counts.push_back(hist[i]);
+      }
+    }
+  } else {
+    // The alphabet is too large for a histogram, hence we sort the positions
+    // by their characters and merge the occurring characters of all PEs.
+    std::vector<size_t> order(positions.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+      [&chars](const size_t a, const size_t b) {
+        return chars[a] < chars[b];
+      });
+
+    std::vector<CharType> local_chars;
+    std::vector<size_t> local_hist;
+    for (size_t i = 0; i < order.size(); ++i) {
+      grouped_positions[i] = positions[order[i]];
+      if (i == 0 || chars[order[i]] != local_chars.back()) {
+        local_chars.push_back(chars[order[i]]);
+        local_hist.push_back(0);
+      }
+      ++local_hist.back();
+    }
+
+    occurring_chars = dsss::mpi::allgatherv(local_chars, env);
+    std::sort(occurring_chars.begin(), occurring_chars.end());
+    occurring_chars.erase(
+      std::unique(occurring_chars.begin(), occurring_chars.end()),
+      occurring_chars.end());
+    local_counts.resize(occurring_chars.size(), 0);
+    for (size_t i = 0, j = 0; i < local_chars.size(); ++i) {
+      while (occurring_chars[j] < local_chars[i]) { ++j; }
+      local_counts[j] = local_hist[i];
+    }
+  }
+  return std::make_tuple(std::move(grouped_positions),
+    std::move(occurring_chars), std::move(local_counts));
+}
+
+struct inducing_config {
+  // Rank the B*-suffixes by sorting the reduced string recursively instead of
+  // using prefix doubling.
+  bool recursive_bs_ranking = false;
+  // Memory budget and scratch directory for the tuples that are discarded
+  // during the prefix doubling based ranking of the B*-suffixes.
+  dsss::spill_config spill;
+  // Checkpoints are written during the ranking of the B*-suffixes, after
+  // sorting the B*-suffixes, and after inducing the B-suffixes. Their names
+  // start with checkpoint_name, which has to be unique among all computations
+  // sharing the checkpoint directory.
+  dsss::mpi::checkpoint_config checkpoint;
+  std::string checkpoint_name = "inducing";
+  // B*-substrings longer than this are sorted by pieces of this length, which
+  // bounds the cost of sorting them on repetitive texts. Ties between pieces
+  // are resolved when ranking the B*-suffixes. Zero means no limit. Only used
+  // for byte alphabets.
+  size_t max_bs_substring_length = 0;
+}; // struct inducing_config
+
+// Computes the suffix array of a text over an integer alphabet. All
+// characters have to be larger than zero. For alphabets larger than a byte,
+// only the buckets of occurring pairs of characters are stored. The optional
+// halo contains the characters following the local text (see
+// distributed_string) and saves communication during the classification.
+template <typename IndexType, typename CharType>
+std::vector<IndexType> inducing(std::vector<CharType>&& local_text,
+  const inducing_config config = inducing_config(),
+  std::vector<CharType> const& halo = std::vector<CharType>()) {
   using bucket_info = bucket_info<IndexType>;
-  
+
+  constexpr bool is_dense = (sizeof(CharType) == 1);
+  using bucket_array = std::conditional_t<is_dense,
+    std::vector<bucket_info>,
+    std::unordered_map<std::uint64_t, bucket_info>>;
+
   dsss::mpi::environment env;
-  // 1. Classify string
-  auto [ classified_strings, b_array ] = idx_b_star_substrings<IndexType>(
-                                           distributed_input);
+  // Check which steps can be skipped, when resuming from a checkpoint
+  const std::string bs_checkpoint =
+    config.checkpoint.path(config.checkpoint_name + "_bs_sorted");
+  const std::string b_checkpoint =
+    config.checkpoint.path(config.checkpoint_name + "_b_induced");
+  const bool use_checkpoints = config.checkpoint.enabled();
+  const bool resume = use_checkpoints && config.checkpoint.resume;
+  std::unique_ptr<dsss::mpi::checkpoint_reader> b_reader;
+  if (resume) {
+    b_reader = std::make_unique<dsss::mpi::checkpoint_reader>(b_checkpoint,
+                                                              env);
+  }
+  const bool b_induced = resume && b_reader->valid();
+
+  std::vector<IndexType> sorted_bs_suffixes;
+  bool bs_sorted = false;
+  if (resume && !b_induced) {
+    dsss::mpi::checkpoint_reader bs_reader(bs_checkpoint, env);
+    if ((bs_sorted = bs_reader.valid())) {
+      sorted_bs_suffixes = bs_reader.read<IndexType>();
+    }
+  }
 
-  distributed_input.string = dsss::mpi::distribute_data(distributed_input.string);
-  size_t local_string_size = distributed_input.string.size();
+  // 1. Classify string and sort B*-substrings
+  size_t local_offset = local_text.size();
+  local_offset = dsss::mpi::ex_prefix_sum(local_offset, env);
+  auto [ classified_strings, b_array, is_b_star ] =
+    sorted_bs_substrings<IndexType, CharType>(local_text, local_offset, halo,
+      !b_induced && !bs_sorted, config.max_bs_substring_length, env);
+  const auto occurring_pairs = b_array.occurring_pairs();
+
+  // The text can be redistributed, as the sorted B*-substrings are copies
+  local_text = dsss::mpi::distribute_data(local_text);
+  size_t local_string_size = local_text.size();
   local_string_size = dsss::mpi::allreduce_sum(local_string_size);
-  dsss::mpi::requestable_array req_text(distributed_input.string, local_string_size);
+  dsss::mpi::requestable_array req_text(local_text, local_string_size);
+
+  // 2. Sort B*-suffixes (unless we resume from a checkpoint)
+  if (!b_induced && !bs_sorted) {
+    doubling_config doubling;
+    doubling.spill = config.spill;
+    doubling.checkpoint = config.checkpoint;
+    doubling.checkpoint_name = config.checkpoint_name + "_bs_doubling";
+    sorted_bs_suffixes = sort_bs_suffixes<IndexType>(classified_strings,
+      config.recursive_bs_ranking, doubling, std::move(is_b_star));
+    if (use_checkpoints) {
+      dsss::mpi::checkpoint_writer writer(bs_checkpoint, 0, env);
+      writer.write(sorted_bs_suffixes);
+    }
+  }
 
-  // 2. Sort B*-substrings & B*-suffixes
-  sort_bs_substrings(classified_strings);
-  std::vector<IndexType> sorted_bs_suffixes =
-    sort_bs_suffixes<IndexType>(classified_strings);
+  constexpr std::uint64_t width = is_dense ?
+    std::uint64_t(std::numeric_limits<CharType>::max()) + 1 :
+    std::uint64_t(1) << 32;
 
-  constexpr size_t max_char = std::numeric_limits<dsss::char_type>::max();
-  std::vector<bucket_info> a_buckets((max_char + 1) * (max_char + 1),
-                                     { 0, 0, 0 });
-  std::vector<bucket_info> b_buckets((max_char + 1) * (max_char + 1),
-                                     { 0, 0, 0 });
+  bucket_array a_buckets;
+  bucket_array b_buckets;
+  if constexpr (is_dense) {
+    a_buckets.resize(width * width, { 0, 0, 0 });
+    b_buckets.resize(width * width, { 0, 0, 0 });
+  } else {
+    a_buckets.reserve(2 * occurring_pairs.size());
+    b_buckets.reserve(2 * occurring_pairs.size());
+  }
 
-  auto suffix_id = [max_char](const size_t c0, const size_t c1) {
-    return c0 + ((max_char + 1) * c1);
+  auto suffix_id = [](const std::uint64_t c0, const std::uint64_t c1) {
+    return c0 + (width * c1);
   };
 
-  auto star_suffix_id = [max_char](const size_t c0, const size_t c1) {
-    return ((max_char + 1) * c0) + c1;
+  auto star_suffix_id = [](const std::uint64_t c0, const std::uint64_t c1) {
+    return (width * c0) + c1;
   };
 
   // 3. Prepare distributed arrays
   // 3.1 Create intervals that will define the distributed arrays
   size_t summed_size = 0;
-  for (size_t c0 = 0; c0 <= max_char; ++c0) {
-    size_t c1;
-    size_t size;
-    for (c1 = 0; c1 < c0; ++c1) {
-      size = compute_local_size(b_array.a(c0, c1));
+  auto add_bucket = [&summed_size](bucket_info& bucket, const size_t size) {
+    bucket = bucket_info(IndexType(summed_size), IndexType(size),
+                         IndexType(0));
+    summed_size += size;
+  };
+  for (const auto& [ c0, c1 ] : occurring_pairs) {
+    if (c1 < c0) {
       // A-Buckets
-      a_buckets[suffix_id(c0, c1)] = bucket_info { summed_size, size, 0 };
-      summed_size += size;
-      size = compute_local_size<true>(b_array.a_star(c0, c1));
+      add_bucket(a_buckets[suffix_id(c0, c1)],
+                 compute_local_size(b_array.a(c0, c1)));
       //A*-Buckets
-      a_buckets[star_suffix_id(c0, c1)] = bucket_info { summed_size, size, 0 };
-      summed_size += size;
-    }
-    // c0 == c1
-    // A-Bucket (there is no A*-Bucket)
-    size = compute_local_size(b_array.a(c0, c0));
-    a_buckets[suffix_id(c0, c0)] = bucket_info { summed_size, size, 0 };
-    summed_size += size;
-    // B-Bucket (there is no B*-Bucket)
-    size = compute_local_size<true>(b_array.b(c0, c0));
-    b_buckets[suffix_id(c0, c0)] = bucket_info { summed_size, size, 0 };
-    summed_size += size;
-    for (c1 = c0 + 1; c1 <= max_char; ++c1) {
-      size = compute_local_size<true>(b_array.b_star(c0, c1));
+      add_bucket(a_buckets[star_suffix_id(c0, c1)],
+                 compute_local_size<true>(b_array.a_star(c0, c1)));
+    } else if (c1 == c0) {
+      // A-Bucket (there is no A*-Bucket)
+      add_bucket(a_buckets[suffix_id(c0, c0)],
+                 compute_local_size(b_array.a(c0, c0)));
+      // B-Bucket (there is no B*-Bucket)
+      add_bucket(b_buckets[suffix_id(c0, c0)],
+                 compute_local_size<true>(b_array.b(c0, c0)));
+    } else {
       //B*-Buckets
-      b_buckets[star_suffix_id(c0, c1)] = bucket_info { summed_size, size, 0 };
-      summed_size += size;
-      size = compute_local_size<true>(b_array.b(c0, c1));
+      add_bucket(b_buckets[star_suffix_id(c0, c1)],
+                 compute_local_size<true>(b_array.b_star(c0, c1)));
       // B-Buckets
-      b_buckets[suffix_id(c0, c1)] = bucket_info { summed_size, size,0 };
-      summed_size += size;
+      add_bucket(b_buckets[suffix_id(c0, c1)],
+                 compute_local_size<true>(b_array.b(c0, c1)));
     }
   }
 
+  // All buckets in the order of their intervals (see 3.1)
+  auto buckets_in_order = [&]() {
+    std::vector<bucket_info*> result;
+    for (const auto& [ c0, c1 ] : occurring_pairs) {
+      if (c1 < c0) {
+        result.push_back(&a_buckets[suffix_id(c0, c1)]);
+        result.push_back(&a_buckets[star_suffix_id(c0, c1)]);
+      } else if (c1 == c0) {
+        result.push_back(&a_buckets[suffix_id(c0, c0)]);
+        result.push_back(&b_buckets[suffix_id(c0, c0)]);
+      } else {
+        result.push_back(&b_buckets[star_suffix_id(c0, c1)]);
+        result.push_back(&b_buckets[suffix_id(c0, c1)]);
+      }
+    }
+    return result;
+  };
 
-  // 3.2 Allocate local part of the SA
-  std::vector<IndexType> local_sa(summed_size, IndexType(0));
+  // 3.2 Allocate local part of the SA (or restore it after the B-suffixes
+  //     have been induced)
+  std::vector<IndexType> local_sa;
+  if (b_induced) {
+    local_sa = b_reader->read<IndexType>();
+    auto containing = b_reader->read<IndexType>();
+    auto buckets = buckets_in_order();
+    for (size_t i = 0; i < buckets.size(); ++i) {
+      buckets[i]->containing = containing[i];
+    }
+    b_reader.reset();
+  } else {
+    local_sa.resize(summed_size, IndexType(0));
+  }
 
-  // 3.3 Fill B*-Buckets
-  sorted_bs_suffixes = dsss::mpi::distribute_data(sorted_bs_suffixes, env);
-  size_t bs_count = sorted_bs_suffixes.size();
-  size_t bs_total_count = dsss::mpi::allreduce_sum(bs_count); // Total size
+  // 3.3 Fill B*-Buckets. The sorted B*-suffixes are sent to the PEs that
+  //     contain their positions in the B*-buckets (see compute_local_size).
+  //     As the suffixes are sorted, each PE receives its parts of the
+  //     B*-buckets in the order of the buckets.
+  if (!b_induced) {
+    size_t bs_count = sorted_bs_suffixes.size();
+    const size_t bs_offset = dsss::mpi::ex_prefix_sum(bs_count, env);
+
+    auto target_rank = [&](const size_t bucket_size, const size_t pos) {
+      const size_t slice = bucket_size / env.size();
+      const size_t first_slice = slice + (bucket_size % env.size());
+      if (bucket_size < size_t(env.size()) || pos < first_slice) {
+        return int32_t(0);
+      }
+      return int32_t(1 + ((pos - first_slice) / slice));
+    };
+
+    std::vector<int32_t> targets;
+    targets.reserve(bs_count);
+    size_t bucket_begin = 0;
+    for (const auto& [ c0, c1 ] : occurring_pairs) {
+      if (c1 <= c0) { continue; }
+      const size_t bucket_size = b_array.b_star(c0, c1);
+      while (targets.size() < bs_count &&
+             bs_offset + targets.size() < bucket_begin + bucket_size) {
+        targets.push_back(target_rank(bucket_size,
+          bs_offset + targets.size() - bucket_begin));
+      }
+      bucket_begin += bucket_size;
+    }
 
-  size_t bs_slice_size = bs_total_count / env.size();
-  size_t last_slice_offset = 0;
-  size_t seen_bs = 0;
-  int32_t cur_root = 0;
-  for (size_t c0 = 0; c0 <= max_char; ++c0) {
-    for (size_t c1 = c0 + 1; c1 <= max_char; ++c1) {
-      if (size_t new_bs = b_array.b_star(c0, c1); new_bs > 0) {
-        if (seen_bs + new_bs < (((cur_root + 1) * bs_slice_size) + last_slice_offset)) {
-          dsss::mpi::scatter_distibuted(sorted_bs_suffixes.data() +
-                                        seen_bs - (cur_root * bs_slice_size),
-                                        new_bs,
-                                        cur_root,
-                                        local_sa.data() +
-                                        b_buckets[star_suffix_id(c0, c1)].starting_position,
-                                        env);
-
-          b_buckets[star_suffix_id(c0, c1)].containing =
-              b_buckets[star_suffix_id(c0, c1)].size;
-          seen_bs += new_bs;
-        } else {
-          int32_t first_target = 0;
-          size_t remaining_bs = new_bs;
-          size_t local_bs_slice = new_bs / env.size();
-          size_t first_bs_larger = new_bs % env.size();
-          size_t still_required = 0;
-          while (remaining_bs > 0) {
-            size_t to_scatter = std::min(remaining_bs,
-                                         (((cur_root + 1 ) * bs_slice_size) +
-                                          last_slice_offset - seen_bs));
-            size_t sent = 0;
-            std::vector<size_t> send_counts(env.size(), 0);
-            for (; first_target < env.size() && to_scatter > 0; ++first_target) {
-              if (first_target > 0) {
-                first_bs_larger = 0;
-              }
-              size_t slice = std::min(to_scatter,
-                                      (still_required > 0 ? still_required :
-                                       local_bs_slice + first_bs_larger));
-              send_counts[first_target] = slice;
-              to_scatter -= slice;
-              sent += slice;
-              still_required = 0;
-            }
-            if (send_counts[first_target - 1] < local_bs_slice) {
-              still_required = local_bs_slice - send_counts[first_target - 1];
-              --first_target;
-            }
-            if (to_scatter > 0) {
-              send_counts.front() += to_scatter;
-              sent += to_scatter;
-            }
+    std::vector<size_t> send_counts(env.size(), 0);
+    for (const auto target : targets) { ++send_counts[target]; }
+    std::vector<size_t> send_pos(env.size(), 0);
+    for (int32_t pe = 1; pe < env.size(); ++pe) {
+      send_pos[pe] = send_pos[pe - 1] + send_counts[pe - 1];
+    }
+    std::vector<IndexType> send_data(bs_count);
+    for (size_t i = 0; i < bs_count; ++i) {
+      send_data[send_pos[targets[i]]++] = sorted_bs_suffixes[i];
+    }
+    targets = std::vector<int32_t>();
+    sorted_bs_suffixes = dsss::mpi::alltoallv(send_data, send_counts, env);
+
+    size_t received_pos = 0;
+    for (const auto& [ c0, c1 ] : occurring_pairs) {
+      if (c1 <= c0) { continue; }
+      bucket_info& bs_bucket = b_buckets[star_suffix_id(c0, c1)];
+      std::copy_n(sorted_bs_suffixes.begin() + received_pos,
+                  size_t(bs_bucket.size),
+                  local_sa.begin() + bs_bucket.starting_position);
+      bs_bucket.containing = bs_bucket.size;
+      received_pos += size_t(bs_bucket.size);
+    }
+  }
 
-            size_t rcvd = dsss::mpi::scatterv(sorted_bs_suffixes.data() +
-                                              seen_bs -
-                                              (cur_root * bs_slice_size),
-                                              sent,
-                                              send_counts,
-                                              cur_root,
-                                              local_sa.data() +
-                                              b_buckets[star_suffix_id(c0, c1)].front_pos(),
-                                              env);
-
-            b_buckets[star_suffix_id(c0, c1)].containing += rcvd;
-            seen_bs += sent;
-            remaining_bs -= sent;
-
-            if (seen_bs == (cur_root + 1) * bs_slice_size) {
-              ++cur_root;
-              if (cur_root + 1 == env.size()) {
-                last_slice_offset = bs_total_count % env.size();
-              }
-            }
-          }
-        }
+  // 4. Induce the remaining suffixes. A suffix s in a c0c0-bucket, which has
+  //    been induced from another c0-bucket, is followed by the suffixes s - 1
+  //    down to the start of its run of c0s. These suffixes are placed in the
+  //    c0c0-bucket directly (see induce_runs) instead of one per round.
+  const size_t text_offset = dsss::mpi::ex_prefix_sum(local_text.size(), env);
+  size_t last_run_start = local_text.size() - 1;
+  while (last_run_start > 0 &&
+         local_text[last_run_start - 1] == local_text.back()) {
+    --last_run_start;
+  }
+  size_t leading_run_start = text_offset;
+  {
+    // Runs can span multiple PEs
+    const auto all_last_chars = dsss::mpi::allgather(local_text.back(), env);
+    size_t global_last_run_start = text_offset + last_run_start;
+    const auto all_last_run_starts =
+      dsss::mpi::allgather(global_last_run_start, env);
+    size_t first_run_start = text_offset;
+    const auto all_offsets = dsss::mpi::allgather(first_run_start, env);
+    for (int32_t pe = env.rank() - 1; pe >= 0 &&
+         all_last_chars[pe] == local_text.front(); --pe) {
+      leading_run_start = all_last_run_starts[pe];
+      if (all_last_run_starts[pe] != all_offsets[pe]) {
+        break;
       }
     }
   }
 
+  // Returns the start of the run of equal characters containing each position
+  auto request_run_starts = [&](std::vector<IndexType>& positions) {
+    return req_text.request(positions, [&](const size_t local_pos) {
+      size_t pos = local_pos;
+      while (pos > 0 && local_text[pos - 1] == local_text[local_pos]) {
+        --pos;
+      }
+      return IndexType(pos == 0 ? leading_run_start : text_offset + pos);
+    });
+  };
+
+  // Places all suffixes that follow the suffixes in the c0c0-bucket (in the
+  // same run of c0s) in the bucket, using a constant number of rounds. The
+  // suffixes that are already contained in the bucket form the first level
+  // and level t consists of their (t - 1)-th predecessors (if they are in the
+  // same run) in the same order. Right to left, levels are placed in front of
+  // their previous levels, left to right behind them. Returns the positions
+  // preceding the runs, which have to be induced into other buckets, in the
+  // order in which inducing one level at a time would have induced them.
+  auto induce_runs = [&](bucket_info& cur_bckt, const size_t global_size,
+                         const bool right_to_left) {
+    std::vector<IndexType> firsts;
+    const size_t first_pos = right_to_left ?
+      cur_bckt.back_pos() : cur_bckt.starting_position;
+    for (size_t i = 0; i < cur_bckt.containing; ++i) {
+      if (size_t val = local_sa[first_pos + i]; DSSS_LIKELY(val > 0)) {
+        firsts.push_back(val);
+      }
+    }
+    auto run_starts = request_run_starts(firsts);
+
+    // The suffixes of the run of firsts[i] are contained in the first
+    // last_levels[i] + 1 levels
+    std::vector<size_t> last_levels(firsts.size());
+    size_t levels = 0;
+    for (size_t i = 0; i < firsts.size(); ++i) {
+      last_levels[i] = size_t(firsts[i]) - size_t(run_starts[i]);
+      levels = std::max(levels, last_levels[i] + 1);
+    }
+    levels = dsss::mpi::allreduce_max(levels, env);
+
+    // Number of suffixes per level and of runs ending in each level. Each
+    // suffix gets its position (from the front) in the bucket, and each run
+    // its position in the returned order, using the offsets of the PE.
+    std::vector<size_t> level_sizes(levels, 0);
+    std::vector<size_t> run_ends(levels, 0);
+    for (size_t i = 0; i < firsts.size(); ++i) {
+      for (size_t level = 0; level <= last_levels[i]; ++level) {
+        ++level_sizes[level];
+      }
+      run_ends[last_levels[i]] += (run_starts[i] > IndexType(0));
+    }
+    auto level_offsets = dsss::mpi::ex_prefix_sum(level_sizes, env);
+    auto run_end_offsets = dsss::mpi::ex_prefix_sum(run_ends, env);
+    const auto global_level_sizes =
+      dsss::mpi::allreduce_sum(level_sizes, env);
+    const auto global_run_ends = dsss::mpi::allreduce_sum(run_ends, env);
+
+    size_t containing = cur_bckt.containing;
+    size_t contained = dsss::mpi::allreduce_sum(containing, env);
+    for (size_t level = 1; level < levels; ++level) {
+      level_offsets[level] += right_to_left ?
+        global_size - contained - global_level_sizes[level] : contained;
+      contained += global_level_sizes[level];
+    }
+    size_t preceding_runs = 0;
+    for (size_t i = 0; i < levels; ++i) {
+      const size_t level = right_to_left ? levels - 1 - i : i;
+      run_end_offsets[level] += preceding_runs;
+      preceding_runs += global_run_ends[level];
+    }
+
+    // Sends the values to the PEs given by target_rank(position), where they
+    // are returned in the order of their positions
+    auto send_to_positions = [&](std::vector<IndexType>& values,
+                                 std::vector<IndexType>& positions,
+                                 auto target_rank) {
+      std::vector<size_t> send_counts(env.size(), 0);
+      for (const auto pos : positions) {
+        ++send_counts[target_rank(pos)];
+      }
+      std::vector<size_t> send_pos(env.size(), 0);
+      for (int32_t pe = 1; pe < env.size(); ++pe) {
+        send_pos[pe] = send_pos[pe - 1] + send_counts[pe - 1];
+      }
+      std::vector<IndexType> send_values(values.size());
+      std::vector<IndexType> send_positions(positions.size());
+      for (size_t i = 0; i < positions.size(); ++i) {
+        const size_t pos = send_pos[target_rank(positions[i])]++;
+        send_values[pos] = values[i];
+        send_positions[pos] = positions[i];
+      }
+      values = dsss::mpi::alltoallv(send_values, send_counts, env);
+      positions = dsss::mpi::alltoallv(send_positions, send_counts, env);
+    };
+
+    // Send the suffixes of all levels (except the first one) to the PEs
+    // containing their positions in the bucket
+    std::vector<IndexType> suffixes;
+    std::vector<IndexType> positions;
+    for (size_t i = 0; i < firsts.size(); ++i) {
+      for (size_t level = 1; level <= last_levels[i]; ++level) {
+        suffixes.push_back(firsts[i] - IndexType(level));
+        positions.push_back(IndexType(level_offsets[level]++));
+      }
+    }
+    size_t local_bucket_size = cur_bckt.size;
+    size_t bucket_offset = dsss::mpi::ex_prefix_sum(local_bucket_size, env);
+    const auto bucket_offsets = dsss::mpi::allgather(bucket_offset, env);
+    send_to_positions(suffixes, positions, [&](const size_t pos) {
+      return int32_t(std::upper_bound(bucket_offsets.begin(),
+        bucket_offsets.end(), pos) - bucket_offsets.begin()) - 1;
+    });
+    for (size_t i = 0; i < suffixes.size(); ++i) {
+      local_sa[cur_bckt.starting_position + positions[i] - bucket_offset] =
+        suffixes[i];
+    }
+    cur_bckt.containing += suffixes.size();
+
+    // Distribute the positions preceding the runs evenly in the returned
+    // order, such that they can be induced at once
+    std::vector<IndexType> preceding;
+    std::vector<IndexType> order;
+    for (size_t i = 0; i < firsts.size(); ++i) {
+      if (run_starts[i] > IndexType(0)) {
+        preceding.push_back(run_starts[i] - IndexType(1));
+        order.push_back(IndexType(run_end_offsets[last_levels[i]]++));
+      }
+    }
+    const size_t slice = std::max<size_t>(1, preceding_runs / env.size());
+    send_to_positions(preceding, order, [&](const size_t pos) {
+      return std::min<int32_t>(pos / slice, env.size() - 1);
+    });
+    std::vector<IndexType> result(preceding.size());
+    for (size_t i = 0; i < preceding.size(); ++i) {
+      result[order[i] - (env.rank() * slice)] = preceding[i];
+    }
+    return result;
+  };
+
   // 4.1 Induce the B-Suffixes
-  dsss::mpi::inducer<IndexType, max_char> ind_util(env);
+  dsss::mpi::inducer<IndexType> ind_util(env);
+
+  // Induces the suffixes at positions req_pos, which are preceding suffixes
+  // starting with c0, from right to left.
+  auto induce_b_positions = [&](const CharType c0,
+                                std::vector<IndexType>& req_pos) {
+    auto res_chars = req_text.request2(req_pos);
+    auto [ to_induce, chars, hist ] = group_by_char(req_pos, res_chars, env);
+
+    // Induce
+    std::vector<IndexType*> start_positions;
+    start_positions.reserve(chars.size());
+    std::vector<size_t> small_hist;
+    small_hist.reserve(chars.size());
+    std::vector<size_t> local_containing;
+    local_containing.reserve(chars.size());
+    std::vector<size_t> global_sizes;
+    global_sizes.reserve(chars.size());
+    std::vector<IndexType*> cur_target_pos;
+    cur_target_pos.reserve(chars.size());
+    std::vector<bucket_info*> tar_buckets;
+    tar_buckets.reserve(chars.size());
+
+    size_t start_p = 0;
+    for (size_t j = 0; j < chars.size(); ++j) {
+      const CharType i = chars[j];
+      bucket_info& tar_bckt = (i <= c0) ? b_buckets[suffix_id(i, c0)] :
+        a_buckets[star_suffix_id(i, c0)];
+      local_containing.push_back(tar_bckt.containing);
+      cur_target_pos.push_back(local_sa.data() + tar_bckt.back_pos());
+      global_sizes.push_back((i <= c0) ? b_array.b(i, c0) :
+                                         b_array.a_star(i, c0));
+      small_hist.push_back(hist[j]);
+      start_positions.push_back(to_induce.data() + start_p);
+      tar_buckets.push_back(&tar_bckt);
+      start_p += hist[j];
+    }
 
-  std::array<size_t, max_char + 1> borders;
-  std::array<size_t, max_char + 1> hist;
+    ind_util.induce_right_to_left(start_positions,
+                                  small_hist,
+                                  local_containing,
+                                  global_sizes,
+                                  cur_target_pos,
+                                  tar_buckets);
+  };
 
-  auto induce_b = [&](const size_t c0, const bucket_info& cur_bckt,
+  auto induce_b = [&](const CharType c0, const bucket_info& cur_bckt,
                       const size_t global_size) {
     if (global_size > 0) {
       std::vector<IndexType> req_pos;
@@ -405,139 +947,65 @@ std::vector<IndexType> inducing(dsss::distributed_string&& distributed_input) {
           req_pos.push_back(val - 1);
         }
       }
-
-      auto res_chars = req_text.request2(req_pos);
- 
-      std::fill_n(borders.begin(), max_char + 1, 0);
-      std::fill_n(hist.begin(), max_char + 1, 0);
-      for (size_t i = 0; i < res_chars.size(); ++i) {
-        ++hist[res_chars[i]];
-      }
-      for (size_t i = 1; i < max_char + 1; ++i) {
-        borders[i] = borders[i - 1] + hist[i - 1];
-      }
-        
-      std::vector<IndexType> to_induce(res_chars.size());
-      for (size_t i = 0; i < res_chars.size(); ++i) {
-        to_induce[borders[res_chars[i]]++] = req_pos[i];
-      }
-      // Induce
-      std::vector<IndexType*> start_positions;
-      start_positions.reserve(max_char + 1);
-      std::vector<size_t> small_hist;
-      small_hist.reserve(max_char + 1);
-      std::vector<size_t> local_containing;
-      local_containing.reserve(max_char + 1);
-      std::vector<size_t> global_sizes;
-      global_sizes.reserve(max_char + 1);
-      std::vector<IndexType*> cur_target_pos;
-      cur_target_pos.reserve(max_char + 1);
-      std::vector<bucket_info*> tar_buckets;
-      tar_buckets.reserve(max_char + 1);
-
-      auto global_hist = dsss::mpi::allreduce_sum(hist, env);
-      size_t start_p = 0;
-      for (size_t i = 0; i < max_char + 1; ++i) {
-        if (global_hist[i] > 0) {
-          bucket_info& tar_bckt = (i <= c0) ? b_buckets[suffix_id(i, c0)] :
-            a_buckets[star_suffix_id(i, c0)];
-          local_containing.push_back(tar_bckt.containing);
-          cur_target_pos.push_back(local_sa.data() + tar_bckt.back_pos());
-          global_sizes.push_back((i <= c0) ? b_array.b(i, c0) :
-                                             b_array.a_star(i, c0));
-          small_hist.push_back(hist[i]);
-          start_positions.push_back(to_induce.data() + start_p);
-          tar_buckets.push_back(&tar_bckt);
-          start_p += hist[i];
-        }
-      }
-
-      ind_util.induce_right_to_left(start_positions,
-                                    small_hist,
-                                    local_containing,
-                                    global_sizes,
-                                    cur_target_pos,
-                                    tar_buckets);
+      induce_b_positions(c0, req_pos);
     }
   };
   
-  auto induce_b_special = [&](size_t const c0, bucket_info const& cur_bckt,
+  auto induce_b_special = [&](const CharType c0, bucket_info& cur_bckt,
                               size_t const global_size) {
     if (global_size > 0) {
-      bool completed = false;
-      size_t cur_pos = 0;
-      while (!completed) {
-        std::vector<IndexType> req_pos;
-        for (; cur_pos < cur_bckt.containing; ++cur_pos) {
-          if (size_t val = local_sa[cur_bckt.starting_position +
-                                    cur_bckt.size - IndexType(1) - cur_pos];
-              DSSS_LIKELY(val > 0)) {
-            req_pos.push_back(val - 1);
-          }
-        }
-        std::reverse(req_pos.begin(), req_pos.end());
-        
-        auto res_chars = req_text.request2(req_pos);
-
-        std::fill_n(borders.begin(), max_char + 1, 0);
-        std::fill_n(hist.begin(), max_char + 1, 0);
-        for (size_t i = 0; i < req_pos.size(); ++i) {
-          ++hist[res_chars[i]];
-        }
-        for (size_t i = 1; i < max_char + 1; ++i) {
-          borders[i] = borders[i - 1] + hist[i - 1];
-        }
-        
-        std::vector<IndexType> to_induce(res_chars.size());
-        for (size_t i = 0; i < res_chars.size(); ++i) {
-          to_induce[borders[res_chars[i]]++] = req_pos[i];
-        }
-
-        // Induce
-        std::vector<IndexType*> start_positions;
-        start_positions.reserve(max_char + 1);
-        std::vector<size_t> small_hist;
-        small_hist.reserve(max_char + 1);
-        std::vector<size_t> local_containing;
-        local_containing.reserve(max_char + 1);
-        std::vector<size_t> global_sizes;
-        global_sizes.reserve(max_char + 1);
-        std::vector<IndexType*> cur_target_pos;
-        cur_target_pos.reserve(max_char + 1);
-        std::vector<bucket_info*> tar_buckets;
-        tar_buckets.reserve(max_char + 1);
-
-        auto global_hist = dsss::mpi::allreduce_sum(hist, env);
-        size_t start_p = 0;
-        for (size_t i = 0; i < max_char + 1; ++i) {
-          if (global_hist[i] > 0) {
-            bucket_info& tar_bckt = (i <= c0) ? b_buckets[suffix_id(i, c0)] :
-              a_buckets[star_suffix_id(i, c0)];
-            local_containing.push_back(tar_bckt.containing);
-            cur_target_pos.push_back(local_sa.data() + tar_bckt.back_pos());
-            global_sizes.push_back((i <= c0) ? b_array.b(i, c0) :
-                                               b_array.a_star(i, c0));
-            small_hist.push_back(hist[i]);
-            start_positions.push_back(to_induce.data() + start_p);
-            tar_buckets.push_back(&tar_bckt);
-            start_p += hist[i];
-          }
-        }
-
-        ind_util.induce_right_to_left(start_positions,
-                                      small_hist,
-                                      local_containing,
-                                      global_sizes,
-                                      cur_target_pos,
-                                      tar_buckets);
+      auto req_pos = induce_runs(cur_bckt, global_size, true);
+      induce_b_positions(c0, req_pos);
+    }
+  };
 
-        bool tmp_completed = (cur_bckt.size == IndexType(cur_pos));
-        completed = dsss::mpi::allreduce_and(tmp_completed);
+  // Induces the suffixes at positions req_pos, which are preceding suffixes
+  // starting with c0, from left to right.
+  auto induce_a_positions = [&](const CharType c0,
+                                std::vector<IndexType>& req_pos) {
+    auto res_chars = req_text.request2(req_pos);
+    auto [ to_induce, chars, hist ] = group_by_char(req_pos, res_chars, env);
+
+    std::vector<IndexType*> start_positions;
+    start_positions.reserve(chars.size());
+    std::vector<size_t> small_hist;
+    small_hist.reserve(chars.size());
+    std::vector<size_t> local_containing;
+    local_containing.reserve(chars.size());
+    std::vector<size_t> global_sizes;
+    global_sizes.reserve(chars.size());
+    std::vector<IndexType*> cur_target_pos;
+    cur_target_pos.reserve(chars.size());
+    std::vector<bucket_info*> tar_buckets;
+    tar_buckets.reserve(chars.size());
+
+    // Suffixes preceded by smaller characters are B-suffixes
+    size_t start_p = 0;
+    for (size_t j = 0; j < chars.size(); ++j) {
+      const CharType i = chars[j];
+      if (i < c0) {
+        start_p += hist[j];
+        continue;
       }
+      bucket_info& tar_bckt = a_buckets[suffix_id(i, c0)];
+      local_containing.push_back(tar_bckt.containing);
+      cur_target_pos.push_back(local_sa.data() + tar_bckt.front_pos());
+      global_sizes.push_back(b_array.a(i, c0));
+      small_hist.push_back(hist[j]);
+      start_positions.push_back(to_induce.data() + start_p);
+      tar_buckets.push_back(&tar_bckt);
+      start_p += hist[j];
     }
+
+    ind_util.induce_left_to_right(start_positions,
+                                  small_hist,
+                                  local_containing,
+                                  global_sizes,
+                                  cur_target_pos,
+                                  tar_buckets);
   };
 
-  auto induce_a = [&](const size_t c0, const bucket_info& cur_bckt,
+  auto induce_a = [&](const CharType c0, const bucket_info& cur_bckt,
                       const size_t global_size) {
     if (global_size > 0) {
       std::vector<IndexType> req_pos;
@@ -548,139 +1016,45 @@ std::vector<IndexType> inducing(dsss::distributed_string&& distributed_input) {
           req_pos.push_back(val - 1);
         }
       }
-      auto res_chars = req_text.request2(req_pos);
-
-      std::fill_n(borders.begin(), max_char + 1, 0);
-      std::fill_n(hist.begin(), max_char + 1, 0);
-      for (size_t i = 0; i < req_pos.size(); ++i) {
-        ++hist[res_chars[i]];
-      }
-      for (size_t i = 1; i < max_char + 1; ++i) {
-        borders[i] = borders[i - 1] + hist[i - 1];
-      }
-        
-      std::vector<IndexType> to_induce(res_chars.size());
-      for (size_t i = 0; i < res_chars.size(); ++i) {
-        to_induce[borders[res_chars[i]]++] = req_pos[i];
-      }
-
-
-      std::vector<IndexType*> start_positions;
-      start_positions.reserve(max_char + 1);
-      std::vector<size_t> small_hist;
-      small_hist.reserve(max_char + 1);
-      std::vector<size_t> local_containing;
-      local_containing.reserve(max_char + 1);
-      std::vector<size_t> global_sizes;
-      global_sizes.reserve(max_char + 1);
-      std::vector<IndexType*> cur_target_pos;
-      cur_target_pos.reserve(max_char + 1);
-      std::vector<bucket_info*> tar_buckets;
-      tar_buckets.reserve(max_char + 1);
-
-      auto global_hist = dsss::mpi::allreduce_sum(hist, env);
-      size_t start_p = (c0 == 0) ? 0 : borders[c0 - 1];;
-      for (size_t i = c0; i < max_char + 1; ++i) {
-        if (global_hist[i] > 0) {
-          bucket_info& tar_bckt = a_buckets[suffix_id(i, c0)];
-          local_containing.push_back(tar_bckt.containing);
-          cur_target_pos.push_back(local_sa.data() + tar_bckt.front_pos());
-          global_sizes.push_back(b_array.a(i, c0));
-          small_hist.push_back(hist[i]);
-          start_positions.push_back(to_induce.data() + start_p);
-          tar_buckets.push_back(&tar_bckt);
-          start_p += hist[i];
-        }
-      }
-
-      ind_util.induce_left_to_right(start_positions,
-                                    small_hist,
-                                    local_containing,
-                                    global_sizes,
-                                    cur_target_pos,
-                                    tar_buckets);
+      induce_a_positions(c0, req_pos);
     }
   };
 
-  auto induce_a_special = [&](size_t const c0, bucket_info const& cur_bckt,
+  auto induce_a_special = [&](const CharType c0, bucket_info& cur_bckt,
                               size_t const global_size) {
     if (global_size > 0) {
-      bool completed = false;
-      size_t cur_pos = 0;
-      while (!completed) {
-        std::vector<IndexType> req_pos;
-        for (; cur_pos < cur_bckt.containing; ++cur_pos) {
-          if (size_t val = local_sa[cur_bckt.starting_position + cur_pos];
-              DSSS_LIKELY(val > 0)) {
-            req_pos.push_back(val - 1);
-          }
-        }
-        auto res_chars = req_text.request2(req_pos);
-
-        std::fill_n(borders.begin(), max_char + 1, 0);
-        std::fill_n(hist.begin(), max_char + 1, 0);
-        for (size_t i = 0; i < req_pos.size(); ++i) {
-          ++hist[res_chars[i]];
-        }
-        for (size_t i = 1; i < max_char + 1; ++i) {
-          borders[i] = borders[i - 1] + hist[i - 1];
-        }
-        
-        std::vector<IndexType> to_induce(res_chars.size());
-        for (size_t i = 0; i < res_chars.size(); ++i) {
-          to_induce[borders[res_chars[i]]++] = req_pos[i];
-        }
-
-        std::vector<IndexType*> start_positions;
-        start_positions.reserve(max_char + 1);
-        std::vector<size_t> small_hist;
-        small_hist.reserve(max_char + 1);
-        std::vector<size_t> local_containing;
-        local_containing.reserve(max_char + 1);
-        std::vector<size_t> global_sizes;
-        global_sizes.reserve(max_char + 1);
-        std::vector<IndexType*> cur_target_pos;
-        cur_target_pos.reserve(max_char + 1);
-        std::vector<bucket_info*> tar_buckets;
-        tar_buckets.reserve(max_char + 1);
-
-        auto global_hist = dsss::mpi::allreduce_sum(hist, env);
-        size_t start_p = (c0 == 0) ? 0 : borders[c0 - 1];;
-        for (size_t i = c0; i < max_char + 1; ++i) {
-          if (global_hist[i] > 0) {
-            bucket_info& tar_bckt = a_buckets[suffix_id(i, c0)];
-            local_containing.push_back(tar_bckt.containing);
-            cur_target_pos.push_back(local_sa.data() + tar_bckt.front_pos());
-            global_sizes.push_back(b_array.a(i, c0));
-            small_hist.push_back(hist[i]);
-            start_positions.push_back(to_induce.data() + start_p);
-            tar_buckets.push_back(&tar_bckt);
-            start_p += hist[i];
-          }
-        }
-
-        ind_util.induce_left_to_right(start_positions,
-                                      small_hist,
-                                      local_containing,
-                                      global_sizes,
-                                      cur_target_pos,
-                                      tar_buckets);
-
-        bool tmp_completed = (cur_bckt.size == IndexType(cur_pos));
-        completed = dsss::mpi::allreduce_and(tmp_completed);
-      }
+      auto req_pos = induce_runs(cur_bckt, global_size, false);
+      induce_a_positions(c0, req_pos);
     }
   };
 
-  for (size_t c0 = max_char; c0 ; --c0) {
-    for (size_t c1 = max_char - 1; c1 > c0; --c1) {
+  // Only buckets of occurring pairs of characters can contain suffixes. They
+  // are considered in the same order as all buckets would be.
+  for (auto it = occurring_pairs.rbegin();
+       !b_induced && it != occurring_pairs.rend(); ++it) {
+    const CharType c0 = it->first;
+    const CharType c1 = it->second;
+    if (c0 == 0 || c1 < c0) {
+      continue;
+    }
+    if (c1 > c0) {
       // Induce from B-bucket
       induce_b(c0, b_buckets[suffix_id(c0, c1)], b_array.b(c0, c1));
       // Induce from B*-bucket
       induce_b(c0, b_buckets[star_suffix_id(c0, c1)], b_array.b_star(c0, c1));
+    } else {
+      // SPECIAL CASE
+      induce_b_special(c0, b_buckets[suffix_id(c0, c0)], b_array.b(c0, c0));
+    }
+  }
+  if (use_checkpoints && !b_induced) {
+    std::vector<IndexType> containing;
+    for (const auto bucket : buckets_in_order()) {
+      containing.push_back(bucket->containing);
     }
-    // SPECIAL CASE
-    induce_b_special(c0, b_buckets[suffix_id(c0, c0)], b_array.b(c0, c0));
+    dsss::mpi::checkpoint_writer writer(b_checkpoint, 0, env);
+    writer.write(local_sa);
+    writer.write(containing);
   }
 
   // 4.2 Put the last suffix at its correct position
@@ -693,21 +1067,22 @@ std::vector<IndexType> inducing(dsss::distributed_string&& distributed_input) {
   }
 
   // 4.3 Induce the A-Suffixes
-  for (size_t c0 = 0; c0 < max_char + 1; ++c0) {
-    for (size_t c1 = 0; c1 < c0; ++c1) {
+  for (const auto& [ c0, c1 ] : occurring_pairs) {
+    if (c1 < c0) {
       // Induce from A-bucket
       induce_a(c0, a_buckets[suffix_id(c0, c1)], b_array.a(c0, c1));
       // Induce from A*-bucket
       induce_a(c0, a_buckets[star_suffix_id(c0, c1)], b_array.a_star(c0, c1));
+    } else if (c1 == c0) {
+      // SPECIAL CASE
+      induce_a_special(c0, a_buckets[suffix_id(c0, c0)], b_array.a(c0, c0));
     }
-    // SPECIAL CASE
-    induce_a_special(c0, a_buckets[suffix_id(c0, c0)], b_array.a(c0, c0));
   }
   
   // 5. Reorder local_sa to contain the local slice of the SA, not the
   //    distrubted arrays
   size_t slice_size = total / env.size();
-  last_slice_offset = 0;
+  size_t last_slice_offset = 0;
   size_t local_size = slice_size + ((env.rank() + 1 == env.size()) ? total % env.size() : 0);
   std::vector<IndexType> sa(local_size, 0);
 
@@ -762,17 +1137,16 @@ std::vector<IndexType> inducing(dsss::distributed_string&& distributed_input) {
     }
   };
 
-  for (size_t c0 = 0; c0 <= max_char; ++c0) {
-    for (size_t c1 = 0; c1 < c0; ++c1) {
+  for (const auto& [ c0, c1 ] : occurring_pairs) {
+    if (c1 < c0) {
       // Gather A-Suffixes
       gather_sa(b_array.a(c0, c1), a_buckets[suffix_id(c0, c1)]);
       // Gather A*-Suffixes
       gather_sa(b_array.a_star(c0, c1), a_buckets[star_suffix_id(c0, c1)]);
-    }
-    // c0 == c1
-    gather_sa(b_array.a(c0, c0), a_buckets[suffix_id(c0, c0)]);
-    gather_sa(b_array.b(c0, c0), b_buckets[suffix_id(c0, c0)]);
-    for (size_t c1 = c0 + 1; c1 <= max_char; ++c1) {
+    } else if (c1 == c0) {
+      gather_sa(b_array.a(c0, c0), a_buckets[suffix_id(c0, c0)]);
+      gather_sa(b_array.b(c0, c0), b_buckets[suffix_id(c0, c0)]);
+    } else {
       // Gather B*-Suffixes
       gather_sa(b_array.b_star(c0, c1), b_buckets[star_suffix_id(c0, c1)]);
       // Gather B-Suffixes
@@ -780,9 +1154,21 @@ std::vector<IndexType> inducing(dsss::distributed_string&& distributed_input) {
     }
   }
 
+  if (use_checkpoints) {
+    dsss::mpi::remove_checkpoint(bs_checkpoint, env);
+    dsss::mpi::remove_checkpoint(b_checkpoint, env);
+  }
   return sa;
 }
 
+template <typename IndexType>
+std::vector<IndexType> inducing(dsss::distributed_string&& distributed_input,
+  const inducing_config config = inducing_config()) {
+
+  return inducing<IndexType, dsss::char_type>(
+    std::move(distributed_input.string), config, distributed_input.halo);
+}
+
 } // namespace dsss::suffix_sorting
 
 /******************************************************************************/
@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * suffix_sorting/inverse_suffix_array.hpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "mpi/allreduce.hpp"
+#include "mpi/alltoall.hpp"
+#include "mpi/environment.hpp"
+#include "mpi/scan.hpp"
+#include "util/macros.hpp"
+
+namespace dsss::suffix_sorting {
+
+// Computes the inverse suffix array, i.e., ISA[SA[i]] = i. Instead of sorting,
+// each pair (SA[i], i) is sent directly to the PE that is responsible for text
+// position SA[i]. The ISA is distributed in text order, using the same blocks
+// as distribute_data.
+template <typename IndexType>
+std::vector<IndexType> inverse_suffix_array(std::vector<IndexType> const& sa,
+  dsss::mpi::environment env = dsss::mpi::environment()) {
+
+  struct position_rank {
+    IndexType index;
+    IndexType rank;
+  } DSSS_ATTRIBUTE_PACKED;
+
+  size_t local_size = sa.size();
+  const size_t total_size = dsss::mpi::allreduce_sum(local_size, env);
+  const size_t offset = dsss::mpi::ex_prefix_sum(local_size, env);
+  const size_t slice_size = std::max<size_t>(1, total_size / env.size());
+
+  auto target_rank = [&](const size_t pos) {
+    return std::min<int32_t>(env.size() - 1, pos / slice_size);
+  };
+
+  std::vector<size_t> send_counts(env.size(), 0);
+  for (const auto& pos : sa) {
+    ++send_counts[target_rank(pos)];
+  }
+  std::vector<size_t> send_positions(env.size(), 0);
+  for (int32_t i = 1; i < env.size(); ++i) {
+    send_positions[i] = send_positions[i - 1] + send_counts[i - 1];
+  }
+  std::vector<position_rank> send_data(local_size);
+  for (size_t i = 0; i < local_size; ++i) {
+    send_data[send_positions[target_rank(sa[i])]++] =
+      position_rank { sa[i], IndexType(offset + i) };
+  }
+
+  auto receive_data = dsss::mpi::alltoallv(send_data, send_counts, env);
+  send_data.clear();
+  send_data.shrink_to_fit();
+
+  const size_t local_offset = env.rank() * slice_size;
+  std::vector<IndexType> isa(receive_data.size());
+  for (const auto& ir : receive_data) {
+    isa[size_t(ir.index) - local_offset] = ir.rank;
+  }
+  return isa;
+}
+
+} // namespace dsss::suffix_sorting
+
+/******************************************************************************/
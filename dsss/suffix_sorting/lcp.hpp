@@ -0,0 +1,187 @@
+/*******************************************************************************
+ * suffix_sorting/lcp.hpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "mpi/allgather.hpp"
+#include "mpi/allreduce.hpp"
+#include "mpi/distribute_data.hpp"
+#include "mpi/environment.hpp"
+#include "mpi/requestable_array.hpp"
+#include "mpi/scan.hpp"
+#include "mpi/shift.hpp"
+#include "mpi/sort.hpp"
+#include "util/macros.hpp"
+#include "util/string.hpp"
+
+namespace dsss::suffix_sorting {
+
+// Computes the LCP array using the permuted LCP array (PLCP) and the Phi
+// array, where Phi[SA[i]] = SA[i - 1]. Only irreducible PLCP values, i.e.,
+// PLCP[j] with T[j - 1] != T[Phi[j] - 1], are computed by comparing
+// characters. Their sum is in O(n log n). All other values are given by
+// PLCP[j] = PLCP[j - 1] - 1. The SA is redistributed using distribute_data
+// and the LCP array has the same distribution, with LCP[0] = 0.
+template <typename IndexType>
+std::vector<IndexType> lcp_array(std::vector<IndexType>& sa,
+  std::vector<dsss::char_type>& local_text,
+  dsss::mpi::environment env = dsss::mpi::environment()) {
+
+  struct phi_pair {
+    IndexType index;
+    IndexType phi;
+  } DSSS_ATTRIBUTE_PACKED;
+
+  struct lce_query {
+    size_t local_pos;
+    size_t text_pos;
+    size_t phi;
+    size_t block_length;
+    size_t requested;
+  };
+
+  struct border_value {
+    size_t local_size;
+    size_t has_irreducible;
+    size_t last_value;
+  };
+
+  size_t total_size = local_text.size();
+  total_size = dsss::mpi::allreduce_sum(total_size, env);
+  local_text = dsss::mpi::distribute_data(local_text, env);
+  dsss::mpi::requestable_array req_text(local_text, total_size, env);
+
+  // 1. Compute Phi in text order (n is used as Phi[SA[0]])
+  sa = dsss::mpi::distribute_data(sa, env);
+  size_t local_size = sa.size();
+  size_t offset = dsss::mpi::ex_prefix_sum(local_size, env);
+
+  // Only the last PEs can be empty (if n < p), hence, all PEs with suffixes
+  // receive the last suffix of the previous PE
+  IndexType last_sa = sa.empty() ? IndexType(0) : sa.back();
+  IndexType prev_sa = dsss::mpi::shift_right(last_sa, env);
+  std::vector<phi_pair> phis;
+  phis.reserve(local_size);
+  for (size_t i = 0; i < local_size; ++i) {
+    if (i > 0) {
+      phis.push_back(phi_pair { sa[i], sa[i - 1] });
+    } else if (offset > 0) {
+      phis.push_back(phi_pair { sa[i], prev_sa });
+    } else {
+      phis.push_back(phi_pair { sa[i], IndexType(total_size) });
+    }
+  }
+  dsss::mpi::balanced_sort(phis, [](const phi_pair& a, const phi_pair& b) {
+    return a.index < b.index;
+  }, env);
+
+  // 2. Identify the irreducible positions
+  local_size = phis.size();
+  offset = dsss::mpi::ex_prefix_sum(local_size, env);
+
+  std::vector<IndexType> req_pos;
+  req_pos.reserve(2 * local_size);
+  for (size_t i = 0; i < local_size; ++i) {
+    const size_t phi = phis[i].phi;
+    if (offset + i > 0 && phi > 0 && phi < total_size) {
+      req_pos.push_back(IndexType(offset + i - 1));
+      req_pos.push_back(IndexType(phi - 1));
+    }
+  }
+  auto res_chars = req_text.request2(req_pos);
+
+  std::vector<IndexType> plcp(local_size, IndexType(0));
+  std::vector<bool> irreducible(local_size, true);
+  std::vector<lce_query> queries;
+  for (size_t i = 0, j = 0; i < local_size; ++i) {
+    const size_t phi = phis[i].phi;
+    if (offset + i > 0 && phi > 0 && phi < total_size) {
+      irreducible[i] = (res_chars[j] != res_chars[j + 1]);
+      j += 2;
+    }
+    if (irreducible[i] && phi < total_size) {
+      queries.push_back(lce_query { i, offset + i, phi, 16, 0 });
+    }
+  }
+  res_chars.clear();
+  res_chars.shrink_to_fit();
+
+  // 3. Compute the irreducible PLCP values by comparing blocks of characters,
+  //    whose lengths are doubled after each successful comparison
+  bool active = !queries.empty();
+  while (dsss::mpi::allreduce_or(active, env)) {
+    req_pos.clear();
+    for (auto& query : queries) {
+      const size_t lcp = plcp[query.local_pos];
+      const size_t max_length = total_size - std::max(query.text_pos,
+                                                      query.phi) - lcp;
+      query.requested = std::min(query.block_length, max_length);
+      for (size_t k = 0; k < query.requested; ++k) {
+        req_pos.push_back(IndexType(query.text_pos + lcp + k));
+        req_pos.push_back(IndexType(query.phi + lcp + k));
+      }
+    }
+    res_chars = req_text.request2(req_pos);
+
+    size_t cur_char = 0;
+    std::vector<lce_query> remaining_queries;
+    for (auto& query : queries) {
+      size_t matching = 0;
+      while (matching < query.requested &&
+             res_chars[cur_char + (2 * matching)] ==
+             res_chars[cur_char + (2 * matching) + 1]) {
+        ++matching;
+      }
+      cur_char += 2 * query.requested;
+      plcp[query.local_pos] += IndexType(matching);
+      if (matching == query.block_length) {
+        query.block_length *= 2;
+        remaining_queries.push_back(query);
+      }
+    }
+    std::swap(queries, remaining_queries);
+    active = !queries.empty();
+  }
+
+  // 4. Compute all reducible PLCP values. The values at the beginning of the
+  //    local slice may depend on the last irreducible value of a previous PE.
+  border_value local_border { local_size, 0, 0 };
+  for (size_t i = 0; i < local_size; ++i) {
+    if (irreducible[i]) {
+      local_border.has_irreducible = 1;
+    } else if (i > 0) {
+      plcp[i] = plcp[i - 1] - IndexType(1);
+    }
+  }
+  if (local_size > 0) {
+    local_border.last_value = plcp.back();
+  }
+  auto borders = dsss::mpi::allgather(local_border, env);
+  size_t carry = 0;
+  for (int32_t rank = 0; rank < env.rank(); ++rank) {
+    if (borders[rank].has_irreducible) {
+      carry = borders[rank].last_value;
+    } else {
+      carry -= borders[rank].local_size;
+    }
+  }
+  for (size_t i = 0; i < local_size && !irreducible[i]; ++i) {
+    plcp[i] = IndexType(--carry);
+  }
+
+  // 5. Permute the PLCP array to SA order: LCP[i] = PLCP[SA[i]]
+  dsss::mpi::requestable_array req_plcp(plcp, total_size, env);
+  return req_plcp.request2(sa);
+}
+
+} // namespace dsss::suffix_sorting
+
+/******************************************************************************/
@@ -8,31 +8,41 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <tuple>
 #include <vector>
 
 #include <tlx/math.hpp>
 
 #include "mpi/allreduce.hpp"
+#include "mpi/alltoall.hpp"
+#include "mpi/checkpoint.hpp"
 #include "mpi/environment.hpp"
 #include "mpi/scan.hpp"
 #include "mpi/shift.hpp"
 #include "mpi/sort.hpp"
 #include "suffix_sorting/data_structs.hpp"
+#include "util/spill_vector.hpp"
 #include "util/string.hpp"
 
 namespace dsss::suffix_sorting {
 
 static constexpr bool debug = false;
 
-template <typename IndexType>
-inline auto pack_alphabet(dsss::distributed_string& distributed_raw_string,
+// Packs as many characters as possible into the initial ranks. The text is
+// only read, hence, it can also be a distributed_string_view.
+template <typename IndexType, typename DistributedString>
+inline auto pack_alphabet(const DistributedString& distributed_raw_string,
   size_t& iteration) {
 
   using IRR = index_rank_rank<IndexType>;
 
   dsss::mpi::environment env;
 
-  std::vector<dsss::char_type>& local_str = distributed_raw_string.string;
+  const auto& local_str = distributed_raw_string.string;
   std::vector<size_t> char_histogram(256, 0);
   for (const auto c : local_str) { ++char_histogram[c]; }
   char_histogram = dsss::mpi::allreduce_sum(char_histogram, env);
@@ -68,34 +78,42 @@ inline auto pack_alphabet(dsss::distributed_string& distributed_raw_string,
   }
 
   size_t local_size = local_str.size();
-  std::vector<dsss::char_type> right_chars = dsss::mpi::shift_left(
-    local_str.data(), 2 * k_fitting, env);
-  if (env.rank() + 1 < env.size()) {
-    std::move(right_chars.begin(), right_chars.end(),
-      std::back_inserter(local_str));
+  // The halo has the same size on all PEs and is padded with 0 at the end of
+  // the text, hence, we only have to ask the neighbor if it is too short.
+  const auto& halo = distributed_raw_string.halo;
+  std::vector<dsss::char_type> right_chars;
+  if (halo.size() >= 2 * k_fitting) {
+    right_chars.assign(halo.begin(), halo.begin() + 2 * k_fitting);
   } else {
-    for (size_t i = 0; i < 2 * k_fitting; ++i) {
-      local_str.emplace_back(0);
-    }
+    std::vector<dsss::char_type> left_chars(local_str.begin(),
+      local_str.begin() + std::min(local_size, 2 * k_fitting));
+    right_chars = dsss::mpi::shift_left(left_chars.data(), left_chars.size(),
+      env);
+    if (env.rank() + 1 == env.size()) { right_chars.clear(); }
+    right_chars.resize(2 * k_fitting, dsss::char_type(0));
   }
+  auto char_at = [&](const size_t i) {
+    return (i < local_size) ? local_str[i] : right_chars[i - local_size];
+  };
 
   size_t index = dsss::mpi::ex_prefix_sum(local_size, env);
   std::vector<IRR> result;
   result.reserve(local_size);
   for (size_t i = 0; i < local_size; ++i) {
-    IndexType rank1 = IndexType(char_map[local_str[i]]);
-    IndexType rank2 = IndexType(char_map[local_str[i + k_fitting]]);
+    IndexType rank1 = IndexType(char_map[char_at(i)]);
+    IndexType rank2 = IndexType(char_map[char_at(i + k_fitting)]);
     for (size_t j = 1; j < k_fitting; ++j) {
-      rank1 = (rank1 << bits_per_char) | char_map[local_str[i + j]];
-      rank2 = (rank2 << bits_per_char) | char_map[local_str[i + k_fitting + j]];
+      rank1 = (rank1 << bits_per_char) | char_map[char_at(i + j)];
+      rank2 = (rank2 << bits_per_char) | char_map[char_at(i + k_fitting + j)];
     }
     result.emplace_back(index++, rank1, rank2);
   }
   return result;
 }
 
-template <typename IndexType>
-std::vector<IndexType> prefix_doubling(dsss::distributed_string&&
+template <typename IndexType,
+          typename DistributedString = dsss::distributed_string>
+std::vector<IndexType> prefix_doubling(DistributedString&&
   distributed_raw_string) {
 
   using IR = index_rank<IndexType>;
@@ -115,18 +133,19 @@ std::vector<IndexType> prefix_doubling(dsss::distributed_string&&
       return std::tie(a.rank1, a.rank2) < std::tie(b.rank1, b.rank2); },
       env);
     
-    // Compute new ranks
+    // Compute new ranks (starting with 1, as 0 is reserved for the end of
+    // the text)
     local_size = irrs.size();
-    offset = dsss::mpi::ex_prefix_sum(local_size);
+    offset = dsss::mpi::ex_prefix_sum(local_size) + 1;
 
     irs.clear();
     irs.reserve(local_size);
 
     size_t cur_rank = offset;
-    irs.emplace_back(irrs[0].index, cur_rank);
+    irs.emplace_back(IndexType(irrs[0].index), cur_rank);
     for (size_t i = 1; i < local_size; ++i) {
       if (irrs[i - 1] != irrs[i]) { cur_rank = offset + i; }
-      irs.emplace_back(irrs[i].index, cur_rank);
+      irs.emplace_back(IndexType(irrs[i].index), cur_rank);
     }
 
     bool all_distinct = true;
@@ -137,15 +156,10 @@ std::vector<IndexType> prefix_doubling(dsss::distributed_string&&
     const bool finished = dsss::mpi::allreduce_and(all_distinct, env);
     if (finished) { break; }
 
-    dsss::mpi::sort(irs, [iteration](const IR& a, const IR& b) {
-        IndexType mod_mask = (size_t(1) << iteration) - 1;
-        IndexType div_mask = ~mod_mask;
-
-        if ((a.index & mod_mask) == (b.index & mod_mask)) {
-          return (a.index & div_mask) < (b.index & div_mask);
-        } else {
-          return (a.index & mod_mask) < (b.index & mod_mask);
-        }
+    dsss::mpi::sort_by_key(irs, [iteration](const IR& x) {
+      const size_t mod_mask = (size_t(1) << iteration) - 1;
+      return std::make_tuple(size_t(x.index) & mod_mask,
+                             size_t(x.index) >> iteration);
     }, env);
 
     local_size = irs.size();
@@ -163,7 +177,8 @@ std::vector<IndexType> prefix_doubling(dsss::distributed_string&&
       if (DSSS_LIKELY(irs[i].index + index_distance == irs[i + 1].index)) {
         second_rank = irs[i + 1].rank;
       }
-      irrs.emplace_back(irs[i].index, irs[i].rank, second_rank);
+      irrs.emplace_back(IndexType(irs[i].index),
+        IndexType(irs[i].rank), second_rank);
     }
     if constexpr (debug) {
       if (env.rank() == 0) {
@@ -180,10 +195,198 @@ std::vector<IndexType> prefix_doubling(dsss::distributed_string&&
   return result;
 }
 
+struct doubling_config {
+  // Memory budget and scratch directory for fully discarded tuples
+  dsss::spill_config spill;
+  // Checkpoints are written every checkpoint.doubling_interval iterations
+  dsss::mpi::checkpoint_config checkpoint;
+  std::string checkpoint_name = "doubling";
+  // Stops after the checkpoint of this iteration has been written and
+  // returns an empty result, e.g., to split the computation into several jobs
+  // that resume from the checkpoints. Zero means that the computation is not
+  // stopped.
+  size_t stop_iteration = 0;
+}; // struct doubling_config
+
+// Sends each tuple to the position given by its key and returns the values
+// of the local positions. The keys have to form the range [0, n) and the
+// positions are distributed like by distribute_data. The discarded tuples are
+// read and sent in chunks that fit into their memory budget, hence, they are
+// never in RAM at once. The remaining tuples are sent afterwards.
+template <typename IndexType, typename KeyFunction, typename ValueFunction>
+std::vector<IndexType> place_tuples(
+  dsss::spill_vector<index_rank<IndexType>> const& discarded,
+  std::vector<index_rank_state<IndexType>> const& irss,
+  KeyFunction key, ValueFunction value,
+  dsss::mpi::environment env = dsss::mpi::environment()) {
+
+  using IR = index_rank<IndexType>;
+
+  size_t local_n = discarded.size() + irss.size();
+  const size_t total_n = dsss::mpi::allreduce_sum(local_n, env);
+  const size_t slice_size = std::max<size_t>(1, total_n / env.size());
+  const size_t local_begin = std::min(total_n, env.rank() * slice_size);
+  const size_t local_end = (env.rank() + 1 == env.size()) ? total_n :
+    std::min(total_n, (env.rank() + 1) * slice_size);
+  std::vector<IndexType> result(local_end - local_begin);
+
+  auto send = [&](auto const& tuples) {
+    auto target = [&](const size_t position) {
+      return std::min<size_t>(env.size() - 1, position / slice_size);
+    };
+    std::vector<size_t> send_counts(env.size(), 0);
+    for (const auto& tuple : tuples) { ++send_counts[target(key(tuple))]; }
+    std::vector<size_t> send_pos(env.size(), 0);
+    for (int32_t pe = 1; pe < env.size(); ++pe) {
+      send_pos[pe] = send_pos[pe - 1] + send_counts[pe - 1];
+    }
+    std::vector<IR> send_data(tuples.size());
+    for (const auto& tuple : tuples) {
+      const size_t position = key(tuple);
+      send_data[send_pos[target(position)]++] =
+        IR { IndexType(position), IndexType(value(tuple)) };
+    }
+    for (const auto& ir : dsss::mpi::alltoallv(send_data, send_counts, env)) {
+      result[size_t(ir.index) - local_begin] = ir.rank;
+    }
+  };
+
+  const size_t chunk_size = discarded.chunk_size();
+  for (size_t begin = 0; true; begin += chunk_size) {
+    bool has_chunk = begin < discarded.size();
+    if (!dsss::mpi::allreduce_or(has_chunk, env)) { break; }
+    send(discarded.read(begin, chunk_size));
+  }
+  send(irss);
+  return result;
+}
+
+// Checkpoint of prefix doubling. It consists of the remaining tuples (tagged
+// with the iteration) and of segments that contain the tuples discarded
+// between two checkpoints, i.e., each checkpoint only writes the newly
+// discarded tuples. The segments are written first, hence, the remaining
+// tuples always refer to complete segments. A checkpoint is only resumed if
+// it has been written for the same number of tuples and the same index type
+// (and by the same number of PEs, see checkpoint_reader).
+template <typename IndexType>
+class doubling_checkpoint {
+
+  using IR = index_rank<IndexType>;
+  using IRS = index_rank_state<IndexType>;
+
+public:
+  doubling_checkpoint(const doubling_config& config, const size_t total_size,
+    dsss::mpi::environment env = dsss::mpi::environment())
+  : config_(config.checkpoint), name_(config.checkpoint_name),
+    total_size_(total_size), env_(env) { }
+
+  // Returns whether there is a checkpoint that can be resumed. Optionally,
+  // reports checkpoints that do not match.
+  bool valid(const bool report = true) {
+    if (!config_.enabled() || !config_.resume) { return false; }
+    dsss::mpi::checkpoint_reader reader(config_.path(name_), env_);
+    if (!reader.valid()) { return false; }
+    auto info = reader.read<std::uint64_t>();
+    bool matches = (info.size() == 3 && info[0] == total_size_ &&
+                    info[1] == sizeof(IndexType));
+    matches = dsss::mpi::allreduce_and(matches, env_);
+    for (size_t segment = 0; matches && segment < info[2]; ++segment) {
+      dsss::mpi::checkpoint_reader segment_reader(segment_path(segment), env_);
+      matches = segment_reader.valid() && segment_reader.tag() == segment;
+      matches = dsss::mpi::allreduce_and(matches, env_);
+    }
+    if (!matches && report && env_.rank() == 0) {
+      std::cout << "Ignoring checkpoint " << config_.path(name_)
+                << ", which does not match the input" << std::endl;
+    }
+    return matches;
+  }
+
+  // Replaces irss by the remaining tuples and appends the discarded tuples.
+  // Returns the iteration of the checkpoint.
+  size_t read(std::vector<IRS>& irss, dsss::spill_vector<IR>& discarded) {
+    dsss::mpi::checkpoint_reader reader(config_.path(name_), env_);
+    segments_ = reader.read<std::uint64_t>()[2];
+    irss = reader.read<IRS>();
+    for (size_t segment = 0; segment < segments_; ++segment) {
+      dsss::mpi::checkpoint_reader segment_reader(segment_path(segment), env_);
+      const size_t chunks = segment_reader.read<std::uint64_t>()[0];
+      for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        for (const auto& ir : segment_reader.read<IR>()) {
+          discarded.emplace_back(ir);
+        }
+      }
+    }
+    written_ = discarded.size();
+    return reader.tag();
+  }
+
+  // The newly discarded tuples are written in chunks that fit into the
+  // memory budget of the spill_vector.
+  void write(const size_t iteration, std::vector<IRS>& irss,
+    dsss::spill_vector<IR> const& discarded) {
+    {
+      dsss::mpi::checkpoint_writer writer(segment_path(segments_), segments_,
+                                          env_);
+      const size_t chunk_size = discarded.chunk_size();
+      size_t chunks =
+        (discarded.size() - written_ + chunk_size - 1) / chunk_size;
+      std::vector<std::uint64_t> chunk_count = {
+        dsss::mpi::allreduce_max(chunks, env_) };
+      writer.write(chunk_count);
+      for (size_t chunk = 0; chunk < chunk_count[0]; ++chunk) {
+        auto tuples = discarded.read(written_ + chunk * chunk_size,
+                                     chunk_size);
+        writer.write(tuples);
+      }
+    }
+    written_ = discarded.size();
+    ++segments_;
+    dsss::mpi::checkpoint_writer writer(config_.path(name_), iteration, env_);
+    std::vector<std::uint64_t> info = {
+      total_size_, sizeof(IndexType), segments_ };
+    writer.write(info);
+    writer.write(irss);
+  }
+
+  void remove() {
+    dsss::mpi::remove_checkpoint(config_.path(name_), env_);
+    // Including a segment that may have been written without its checkpoint
+    for (size_t segment = 0; segment <= segments_; ++segment) {
+      dsss::mpi::remove_checkpoint(segment_path(segment), env_);
+    }
+  }
+
+private:
+  std::string segment_path(const size_t segment) const {
+    return config_.path(name_ + "_discarded_" + std::to_string(segment));
+  }
+
+  dsss::mpi::checkpoint_config config_;
+  std::string name_;
+  std::uint64_t total_size_;
+  dsss::mpi::environment env_;
+  std::uint64_t segments_ = 0;
+  // Number of discarded tuples that are contained in the segments
+  size_t written_ = 0;
+
+}; // class doubling_checkpoint
+
+// Fully discarded tuples are not required until all ranks are unique. If a
+// memory budget is given, they are spilled to a scratch file in the meantime
+// and, in the end, sent to their final positions in chunks that fit into the
+// budget (see place_tuples). For the ISA, the indices have to form the range
+// [0, n).
+// If checkpoints are enabled, one is written at the beginning of every
+// iteration that is a multiple of checkpoint.doubling_interval (see
+// doubling_checkpoint). When resuming from a checkpoint for total_size tuples
+// (the remaining and the already discarded ones), irss and iteration are
+// replaced by the content of the checkpoint.
 template <typename IndexType, bool return_isa = false>
 std::vector<IndexType> doubling_discarding(
   std::vector<index_rank_state<IndexType>>& irss,
-  size_t iteration,
+  size_t iteration, const size_t total_size,
+  const doubling_config& config = doubling_config(),
   dsss::mpi::environment env = dsss::mpi::environment()) {
 
   using IR = index_rank<IndexType>;
@@ -191,18 +394,36 @@ std::vector<IndexType> doubling_discarding(
   using IRR = index_rank_rank<IndexType>;
 
   std::vector<IRR> irrs;
-  std::vector<IR> fully_discarded;
-  while (iteration) {
-    auto start_time = MPI_Wtime();
-    dsss::mpi::sort(irss, [iteration](const IRS& a, const IRS& b) {
-      IndexType mod_mask = (size_t(1) << iteration) - 1;
-      IndexType div_mask = ~mod_mask;
+  dsss::spill_vector<IR> discarded(config.spill,
+    "dsss_discarded_" + std::to_string(env.rank()));
+
+  doubling_checkpoint<IndexType> checkpoint(config, total_size, env);
+  const size_t checkpoint_interval =
+    std::max<size_t>(1, config.checkpoint.doubling_interval);
+  size_t checkpoint_iteration = 0;
+  if (checkpoint.valid()) {
+    iteration = checkpoint_iteration = checkpoint.read(irss, discarded);
+    if (env.rank() == 0) {
+      std::cout << "Resuming prefix doubling at iteration " << iteration
+                << std::endl;
+    }
+  }
 
-      if ((a.index & mod_mask) == (b.index & mod_mask)) {
-        return (a.index & div_mask) < (b.index & div_mask);
-      } else {
-        return (a.index & mod_mask) < (b.index & mod_mask);
+  while (iteration) {
+    if (config.checkpoint.enabled() &&
+        iteration % checkpoint_interval == 0 &&
+        iteration != checkpoint_iteration) {
+      checkpoint.write(iteration, irss, discarded);
+      checkpoint_iteration = iteration;
+      if (iteration == config.stop_iteration) {
+        return std::vector<IndexType>();
       }
+    }
+    auto start_time = MPI_Wtime();
+    dsss::mpi::sort_by_key(irss, [iteration](const IRS& x) {
+      const size_t mod_mask = (size_t(1) << iteration) - 1;
+      return std::make_tuple(size_t(x.index) & mod_mask,
+                             size_t(x.index) >> iteration);
     }, env);
 
     if constexpr (debug) {
@@ -249,7 +470,7 @@ std::vector<IndexType> doubling_discarding(
           unique.emplace_back(irss[i]);
         }
         else {
-          fully_discarded.emplace_back(irss[i].index, irss[i].rank);
+          discarded.emplace_back(IR { irss[i].index, irss[i].rank });
         }
         prev_non_unique = 0;
       } else {
@@ -257,7 +478,8 @@ std::vector<IndexType> doubling_discarding(
         if (DSSS_LIKELY(irss[i].index + index_distance == irss[i + 1].index)) {
           second_rank = irss[i + 1].rank;
         }
-        irrs.emplace_back(irss[i].index, irss[i].rank, second_rank);
+        irrs.emplace_back(IndexType(irss[i].index),
+          IndexType(irss[i].rank), second_rank);
         ++prev_non_unique;
       }
     }
@@ -268,7 +490,7 @@ std::vector<IndexType> doubling_discarding(
         std::cout << "Discarded in iteration " << iteration << std::endl;
       }
       env.barrier();
-      size_t local_discarded = fully_discarded.size();
+      size_t local_discarded = discarded.size();
       size_t local_unique = unique.size();
       size_t local_undecided = irrs.size();
 
@@ -301,7 +523,7 @@ std::vector<IndexType> doubling_discarding(
                   << std::endl;
       }
       env.barrier();
-      size_t local_discarded = fully_discarded.size();
+      size_t local_discarded = discarded.size();
       size_t local_unique = unique.size();
       size_t local_undecided = irrs.size();
 
@@ -349,7 +571,7 @@ std::vector<IndexType> doubling_discarding(
       }
       cur_rank = irrs[0].rank1 + offset;
       ++offset;
-      irss.emplace_back(irrs[0].index, cur_rank, rank_state::UNIQUE);
+      irss.emplace_back(IndexType(irrs[0].index), cur_rank, rank_state::UNIQUE);
     }
     for (size_t i = 1; i < local_size; ++i) {
       if (irrs[i].rank1 == irrs[i - 1].rank1) {
@@ -361,7 +583,7 @@ std::vector<IndexType> doubling_discarding(
         offset = 1;
         cur_rank = irrs[i].rank1;
       }
-      irss.emplace_back(irrs[i].index, cur_rank, rank_state::UNIQUE);
+      irss.emplace_back(IndexType(irrs[i].index), cur_rank, rank_state::UNIQUE);
     }
 
     if constexpr (debug) {
@@ -395,7 +617,7 @@ std::vector<IndexType> doubling_discarding(
     }
 
     if constexpr (debug) {
-      size_t local_discarded = fully_discarded.size();
+      size_t local_discarded = discarded.size();
       size_t local_unique = unique.size();
       size_t local_undecided = irss.size();
 
@@ -435,42 +657,26 @@ std::vector<IndexType> doubling_discarding(
     }
     env.barrier();
   }
-  fully_discarded.reserve(fully_discarded.size() + irss.size());
-  std::transform(irss.begin(), irss.end(),
-    std::back_inserter(fully_discarded),
-    [](const IRS& irs) {
-      return IR { irs.index, irs.rank };
-    });
-  
+  if (config.checkpoint.enabled()) {
+    checkpoint.remove();
+  }
+  // Ranks start with 1, as 0 is reserved for the end of the text. As all
+  // ranks are unique, they form the range [1, n].
+  auto rank = [](const auto& ir) { return size_t(ir.rank) - 1; };
+  auto index = [](const auto& ir) { return size_t(ir.index); };
   if constexpr (return_isa) {
-    dsss::mpi::sort(fully_discarded, [](const IR& a, const IR& b) {
-      return a.index < b.index;
-    }, env);
+    // The ISA is distributed like the text
+    return place_tuples<IndexType>(discarded, irss, index, rank, env);
   } else {
-    dsss::mpi::sort(fully_discarded, [](const IR& a, const IR& b) {
-      return a.rank < b.rank;
-    }, env);
+    return place_tuples<IndexType>(discarded, irss, rank, index, env);
   }
-  
-  std::vector<IndexType> result;
-  result.reserve(fully_discarded.size());
-
-  std::transform(fully_discarded.begin(), fully_discarded.end(),
-    std::back_inserter(result),
-    [](const IR& ir) {
-      if constexpr (return_isa) {
-        return ir.rank;
-      } else {
-        return ir.index;
-      }
-    });
-
-  return result;
 }
 
-template <typename IndexType, bool return_isa = false>
+template <typename IndexType, bool return_isa = false,
+          typename DistributedString = dsss::distributed_string>
 std::vector<IndexType> prefix_doubling_discarding(
-  dsss::distributed_string&& distributed_raw_string) {
+  DistributedString&& distributed_raw_string,
+  const doubling_config& config = doubling_config()) {
 
   using IR = index_rank<IndexType>;
   using IRS = index_rank_state<IndexType>;
@@ -478,6 +684,15 @@ std::vector<IndexType> prefix_doubling_discarding(
 
   dsss::mpi::environment env;
 
+  // Skip the first iteration, if there is a checkpoint to resume from
+  size_t total_size = distributed_raw_string.string.size();
+  total_size = dsss::mpi::allreduce_sum(total_size, env);
+  if (doubling_checkpoint<IndexType>(config, total_size, env).valid(false)) {
+    std::vector<IRS> irss;
+    return doubling_discarding<IndexType, return_isa>(irss, 0, total_size,
+                                                      config, env);
+  }
+
   size_t offset = 0;
   size_t local_size = 0;
   size_t iteration = 0;
@@ -489,20 +704,21 @@ std::vector<IndexType> prefix_doubling_discarding(
     return std::tie(a.rank1, a.rank2) < std::tie(b.rank1, b.rank2); },
     env);
   
-  // Compute new ranks
+  // Compute new ranks (starting with 1, as 0 is reserved for the end of the
+  // text)
   local_size = irrs.size();
-  offset = dsss::mpi::ex_prefix_sum(local_size);
+  offset = dsss::mpi::ex_prefix_sum(local_size) + 1;
 
   irs.clear();
   irs.reserve(local_size);
 
   size_t cur_rank = offset;
-  irs.emplace_back(irrs[0].index, cur_rank);
+  irs.emplace_back(IndexType(irrs[0].index), cur_rank);
   for (size_t i = 1; i < local_size; ++i) {
     if (irrs[i - 1] != irrs[i]) {
       cur_rank = offset + i;
     }
-    irs.emplace_back(irrs[i].index, cur_rank);
+    irs.emplace_back(IndexType(irrs[i].index), cur_rank);
   }
 
   bool all_distinct = true;
@@ -516,20 +732,25 @@ std::vector<IndexType> prefix_doubling_discarding(
   if (finished) { 
     std::vector<IndexType> result;
     result.reserve(irs.size());
-    std::transform(irs.begin(), irs.end(), std::back_inserter(result),
-                   [](const IR& ir) { return ir.index; });
+    if constexpr (return_isa) {
+      dsss::mpi::sort(irs, [](const IR& a, const IR& b) {
+        return a.index < b.index;
+      }, env);
+      std::transform(irs.begin(), irs.end(), std::back_inserter(result),
+                     [](const IR& ir) {
+                       return IndexType(ir.rank - IndexType(1));
+                     });
+    } else {
+      std::transform(irs.begin(), irs.end(), std::back_inserter(result),
+                     [](const IR& ir) { return ir.index; });
+    }
     return result;
   }
 
-  dsss::mpi::sort(irs, [iteration](const IR& a, const IR& b) {
-    IndexType mod_mask = (size_t(1) << iteration) - 1;
-    IndexType div_mask = ~mod_mask;
-
-    if ((a.index & mod_mask) == (b.index & mod_mask)) {
-      return (a.index & div_mask) < (b.index & div_mask);
-    } else {
-      return (a.index & mod_mask) < (b.index & mod_mask);
-    }
+  dsss::mpi::sort_by_key(irs, [iteration](const IR& x) {
+    const size_t mod_mask = (size_t(1) << iteration) - 1;
+    return std::make_tuple(size_t(x.index) & mod_mask,
+                           size_t(x.index) >> iteration);
   }, env);
 
   local_size = irs.size();
@@ -550,7 +771,8 @@ std::vector<IndexType> prefix_doubling_discarding(
     if (DSSS_LIKELY(irs[i].index + index_distance == irs[i + 1].index)) {
       second_rank = irs[i + 1].rank;
     }
-    irrs.emplace_back(irs[i].index, irs[i].rank, second_rank);
+    irrs.emplace_back(IndexType(irs[i].index),
+      IndexType(irs[i].rank), second_rank);
   }
 
   irs.clear();
@@ -565,12 +787,12 @@ std::vector<IndexType> prefix_doubling_discarding(
   irss.reserve(local_size);
   offset = dsss::mpi::ex_prefix_sum(local_size, env) + 1;
   cur_rank = offset;
-  irss.emplace_back(irrs[0].index, cur_rank, rank_state::NONE);
+  irss.emplace_back(IndexType(irrs[0].index), cur_rank, rank_state::NONE);
   for (size_t i = 1; i < local_size; ++i) {
     if (irrs[i - 1] != irrs[i]) {
       cur_rank = offset + i;
     }
-    irss.emplace_back(irrs[i].index, cur_rank, rank_state::NONE);
+    irss.emplace_back(IndexType(irrs[i].index), cur_rank, rank_state::NONE);
   }
   if (irss.size() == 1) {
     irss[0].state = rank_state::UNIQUE;
@@ -601,7 +823,8 @@ std::vector<IndexType> prefix_doubling_discarding(
     env.barrier();
   }
   ++iteration;
-  return doubling_discarding<IndexType, return_isa>(irss, iteration, env);
+  return doubling_discarding<IndexType, return_isa>(irss, iteration,
+                                                    total_size, config, env);
 }
 
 } // namespace dsss::suffix_sorting
@@ -8,15 +8,22 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <random>
 #include <vector>
 
+#include "mpi/allgather.hpp"
 #include "mpi/allreduce.hpp"
+#include "mpi/broadcast.hpp"
 #include "mpi/distribute_data.hpp"
 #include "mpi/environment.hpp"
+#include "mpi/requestable_array.hpp"
 #include "mpi/scan.hpp"
 #include "mpi/shift.hpp"
 #include "mpi/sort.hpp"
 #include "mpi/zip.hpp"
+#include "util/fingerprint.hpp"
 #include "util/macros.hpp"
 #include "util/string.hpp"
 
@@ -54,10 +61,8 @@ bool check(std::vector<IndexType>& sa,
       return sa_tuple { i + IndexType(1), sa_pos };
     });
 
-  dsss::mpi::sort(sa_tuples, [](const sa_tuple& a, const sa_tuple& b) {
-    return a.sa < b.sa;
-  });
-  sa_tuples = dsss::mpi::distribute_data(sa_tuples);
+  dsss::mpi::balanced_sort(sa_tuples,
+    [](const sa_tuple& a, const sa_tuple& b) { return a.sa < b.sa; });
   env.barrier();
 
   size_t local_size = sa_tuples.size();
@@ -73,7 +78,6 @@ bool check(std::vector<IndexType>& sa,
     return false;
   }
 
-  sa_tuples = dsss::mpi::distribute_data(sa_tuples);
   text = dsss::mpi::distribute_data(text);
 
   sa_tuple tuple_to_right = dsss::mpi::shift_left(sa_tuples.front());
@@ -121,6 +125,191 @@ bool check(std::vector<IndexType>& sa,
   return is_correct;
 }
 
+// Probabilistic check of the SA that does not require any sorting. The
+// permutation property is checked by comparing the multiset hashes
+// prod (z - SA[i]) and prod (z - i) modulo 2^61 - 1 for a random z. Then,
+// a fraction (sample_ratio) of all adjacent pairs SA[i], SA[i + 1] is chosen
+// at random and the corresponding suffixes are compared using LCE queries,
+// which are answered by binary search on Karp-Rabin fingerprints of the text.
+// A correct SA is always accepted. An SA with k wrongly ordered neighbors is
+// accepted with probability about (1 - sample_ratio)^k.
+template <typename IndexType>
+bool check_probabilistic(std::vector<IndexType>& sa,
+  std::vector<dsss::char_type>& text, const double sample_ratio = 0.01,
+  dsss::mpi::environment env = dsss::mpi::environment()) {
+
+  using mod = dsss::mersenne_61;
+
+  struct fingerprint_size {
+    std::uint64_t fingerprint;
+    std::uint64_t size;
+  };
+
+  struct lce_query {
+    std::uint64_t first;
+    std::uint64_t second;
+    std::uint64_t lower;
+    std::uint64_t upper;
+  };
+
+  size_t local_size = sa.size();
+  const size_t total_size = dsss::mpi::allreduce_sum(local_size, env);
+  size_t local_text_size = text.size();
+  if (total_size == 0 ||
+      total_size != dsss::mpi::allreduce_sum(local_text_size, env)) {
+    return false;
+  }
+  sa = dsss::mpi::distribute_data(sa, env);
+  text = dsss::mpi::distribute_data(text, env);
+  local_size = sa.size();
+  local_text_size = text.size();
+  const size_t text_offset = dsss::mpi::ex_prefix_sum(local_text_size, env);
+
+  std::uint64_t seed = 0;
+  if (env.rank() == 0) {
+    std::random_device rand_seed;
+    seed = (std::uint64_t(rand_seed()) << 32) | rand_seed();
+  }
+  seed = dsss::mpi::broadcast(seed, 0, env);
+  std::mt19937_64 rand_gen(seed);
+  const std::uint64_t z = rand_gen() % mod::prime;
+  const std::uint64_t base = 256 + (rand_gen() % (mod::prime - 256));
+  rand_gen.seed(seed + env.rank() + 1);
+
+  // 1. Check if the SA is a permutation of [0, n)
+  bool in_range = true;
+  std::uint64_t sa_hash = 1;
+  for (const auto& pos : sa) {
+    in_range &= (size_t(pos) < total_size);
+    sa_hash = mod::mul(sa_hash, mod::sub(z, std::uint64_t(pos)));
+  }
+  std::uint64_t id_hash = 1;
+  for (size_t i = 0; i < local_text_size; ++i) {
+    id_hash = mod::mul(id_hash, mod::sub(z, text_offset + i));
+  }
+  auto sa_hashes = dsss::mpi::allgather(sa_hash, env);
+  auto id_hashes = dsss::mpi::allgather(id_hash, env);
+  for (int32_t rank = 1; rank < env.size(); ++rank) {
+    sa_hashes[0] = mod::mul(sa_hashes[0], sa_hashes[rank]);
+    id_hashes[0] = mod::mul(id_hashes[0], id_hashes[rank]);
+  }
+  if (!dsss::mpi::allreduce_and(in_range, env) ||
+      sa_hashes[0] != id_hashes[0]) {
+    if (env.rank() == 0) { std::cout << "NO PERM" << std::endl; }
+    return false;
+  }
+
+  // 2. Compute the fingerprints of all prefixes of the text, i.e.,
+  //    prefix[i] = fingerprint(T[0, i)). prefix[n] is the fingerprint of the
+  //    whole text, which is known to all PEs. It is answered by the PE that
+  //    position n is mapped to (which is not the last PE if n < p).
+  fingerprint_size local_fs { 0, local_text_size };
+  for (const auto& character : text) {
+    local_fs.fingerprint = mod::add(mod::mul(local_fs.fingerprint, base),
+                                    std::uint64_t(character));
+  }
+  auto all_fs = dsss::mpi::allgather(local_fs, env);
+  std::uint64_t previous = 0;
+  std::uint64_t whole_text = 0;
+  for (int32_t rank = 0; rank < env.size(); ++rank) {
+    if (rank == env.rank()) { previous = whole_text; }
+    whole_text = mod::add(mod::mul(whole_text,
+      mod::pow(base, all_fs[rank].size)), all_fs[rank].fingerprint);
+  }
+  std::vector<std::uint64_t> prefix;
+  prefix.reserve(local_text_size);
+  for (const auto& character : text) {
+    prefix.push_back(previous);
+    previous = mod::add(mod::mul(previous, base), std::uint64_t(character));
+  }
+  dsss::mpi::requestable_array req_prefix(prefix, total_size, env);
+  dsss::mpi::requestable_array req_text(text, total_size, env);
+
+  // 3. Sample adjacent pairs of the SA
+  //    (Only the last PEs can be empty (if n < p), hence, the successor of
+  //    the last local suffix is the first suffix of the next PE, unless it is
+  //    the last suffix of the SA.)
+  IndexType first_sa = sa.empty() ? IndexType(0) : sa.front();
+  IndexType next_sa = dsss::mpi::shift_left(first_sa, env);
+  std::bernoulli_distribution sample(std::min(1.0, sample_ratio));
+  std::vector<lce_query> queries;
+  for (size_t i = 0; i < local_size; ++i) {
+    if (text_offset + i + 1 == total_size) { break; }
+    if (sample(rand_gen)) {
+      const std::uint64_t first = sa[i];
+      const std::uint64_t second = (i + 1 < local_size) ? sa[i + 1] : next_sa;
+      queries.push_back(lce_query { first, second, 0,
+        total_size - std::max(first, second) });
+    }
+  }
+
+  // 4. Compute the LCE of each pair using binary search, i.e., the LCE is in
+  //    [lower, upper] and we compare the fingerprints of length
+  //    (lower + upper + 1) / 2 in each round.
+  auto fingerprint = [&](const std::uint64_t start_prefix,
+    const std::uint64_t end_prefix, const std::uint64_t length) {
+    return mod::sub(end_prefix, mod::mul(start_prefix, mod::pow(base,
+                                                                length)));
+  };
+  std::vector<std::uint64_t> req_pos;
+  bool active = !queries.empty();
+  while (dsss::mpi::allreduce_or(active, env)) {
+    req_pos.clear();
+    for (const auto& query : queries) {
+      if (query.lower < query.upper) {
+        const std::uint64_t length = (query.lower + query.upper + 1) / 2;
+        req_pos.push_back(query.first);
+        req_pos.push_back(query.first + length);
+        req_pos.push_back(query.second);
+        req_pos.push_back(query.second + length);
+      }
+    }
+    auto res_prefix = req_prefix.request(req_pos, [&](const size_t pos) {
+      return (pos < prefix.size()) ? prefix[pos] : whole_text;
+    });
+    active = false;
+    for (size_t i = 0, j = 0; i < queries.size(); ++i) {
+      auto& query = queries[i];
+      if (query.lower < query.upper) {
+        const std::uint64_t length = (query.lower + query.upper + 1) / 2;
+        if (fingerprint(res_prefix[j], res_prefix[j + 1], length) ==
+            fingerprint(res_prefix[j + 2], res_prefix[j + 3], length)) {
+          query.lower = length;
+        } else {
+          query.upper = length - 1;
+        }
+        j += 4;
+        active |= (query.lower < query.upper);
+      }
+    }
+  }
+
+  // 5. Compare the first mismatching characters. If one suffix is a prefix of
+  //    the other one, it must be the smaller suffix.
+  bool is_sorted = true;
+  req_pos.clear();
+  for (const auto& query : queries) {
+    if (query.first + query.lower == total_size) {
+      continue;
+    } else if (query.second + query.lower == total_size) {
+      is_sorted = false;
+    } else {
+      req_pos.push_back(query.first + query.lower);
+      req_pos.push_back(query.second + query.lower);
+    }
+  }
+  auto res_chars = req_text.request2(req_pos);
+  for (size_t i = 0; i < res_chars.size(); i += 2) {
+    is_sorted &= (res_chars[i] < res_chars[i + 1]);
+  }
+
+  bool is_correct = dsss::mpi::allreduce_and(is_sorted, env);
+  if (!is_correct && env.rank() == 0) {
+    std::cout << "NOT SORTED" << std::endl;
+  }
+  return is_correct;
+}
+
 } // namespace dsss::suffix_sorting
 
 /******************************************************************************/
@@ -0,0 +1,94 @@
+/*******************************************************************************
+ * util/fingerprint.hpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include "util/string.hpp"
+
+namespace dsss {
+
+// Arithmetic modulo the Mersenne prime 2^61 - 1, which can be reduced without
+// divisions. It is used for Karp-Rabin fingerprints and multiset hashes.
+struct mersenne_61 {
+  static constexpr std::uint64_t prime = (std::uint64_t(1) << 61) - 1;
+
+  static inline std::uint64_t reduce(const std::uint64_t value) {
+    const std::uint64_t result = (value & prime) + (value >> 61);
+    return (result >= prime) ? result - prime : result;
+  }
+
+  static inline std::uint64_t add(const std::uint64_t a,
+                                  const std::uint64_t b) {
+    return reduce(a + b);
+  }
+
+  static inline std::uint64_t sub(const std::uint64_t a,
+                                  const std::uint64_t b) {
+    return reduce(a + prime - b);
+  }
+
+  static inline std::uint64_t mul(const std::uint64_t a,
+                                  const std::uint64_t b) {
+    // __extension__ silences -Wpedantic, which warns about __int128
+    __extension__ const unsigned __int128 product =
+      (unsigned __int128)(a) * b;
+    const std::uint64_t low = std::uint64_t(product) & prime;
+    const std::uint64_t high = std::uint64_t(product >> 61);
+    return reduce(low + high);
+  }
+
+  static inline std::uint64_t pow(std::uint64_t base, std::uint64_t exp) {
+    std::uint64_t result = 1;
+    while (exp > 0) {
+      if (exp & 1) { result = mul(result, base); }
+      base = mul(base, base);
+      exp >>= 1;
+    }
+    return result;
+  }
+}; // struct mersenne_61
+
+// Order-independent hash of a multiset of strings. Each string is mapped to
+// its Karp-Rabin fingerprint f and the multiset to prod (z - f) modulo
+// 2^61 - 1. For random base and z, different multisets of n strings of
+// length at most l have the same hash with probability O(n^2 * l / 2^61).
+// Hashes of parts of a multiset are combined by multiplying them.
+class string_multiset_hash {
+  using mod = mersenne_61;
+
+public:
+  string_multiset_hash(const std::uint64_t base, const std::uint64_t z)
+    : base_(base), z_(z) { }
+
+  void add(const dsss::string str) {
+    std::uint64_t fingerprint = 0;
+    for (auto c = str; *c != dsss::char_type(0); ++c) {
+      fingerprint = mod::add(mod::mul(fingerprint, base_), *c);
+    }
+    hash_ = mod::mul(hash_, mod::sub(z_, fingerprint));
+  }
+
+  void combine(const std::uint64_t other_hash) {
+    hash_ = mod::mul(hash_, other_hash);
+  }
+
+  inline std::uint64_t value() const {
+    return hash_;
+  }
+
+private:
+  std::uint64_t base_;
+  std::uint64_t z_;
+  std::uint64_t hash_ = 1;
+}; // class string_multiset_hash
+
+} // namespace dsss
+
+/******************************************************************************/
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 
 #include "util/macros.hpp"
@@ -38,6 +39,59 @@ static inline bool string_smaller_eq(const indexed_string<IndexType>& a,
   return dsss::string_smaller_eq(a.string, b.string);
 }
 
+template <typename IndexType>
+static inline bool string_smaller_eq(const indexed_string<IndexType>& a,
+  const dsss::string b) {
+  return dsss::string_smaller_eq(a.string, b);
+}
+
+// A substring of a text that is not terminated by 0 but has a length. This
+// way, the substring can point into the text instead of being copied. All
+// characters have to be larger than 0, such that substrings are ordered like
+// the corresponding 0-terminated strings.
+template <typename IndexType>
+struct indexed_substring {
+  IndexType index;
+  dsss::string string;
+  IndexType length;
+
+  inline dsss::char_type operator [](const std::size_t depth) const {
+    return (depth < std::size_t(length)) ? string[depth] : 0;
+  }
+} DSSS_ATTRIBUTE_PACKED; // struct indexed_substring
+
+template <typename IndexType>
+static inline std::size_t string_length(
+  const indexed_substring<IndexType>& str) {
+  return str.length;
+}
+
+template <typename IndexType>
+static inline std::int64_t string_cmp(const indexed_substring<IndexType>& a,
+  const indexed_substring<IndexType>& b) {
+  const std::size_t length = std::min<std::size_t>(a.length, b.length);
+  std::size_t depth = 0;
+  while (depth < length && a.string[depth] == b.string[depth]) { ++depth; }
+  return std::int64_t(a[depth]) - std::int64_t(b[depth]);
+}
+
+template <typename IndexType>
+static inline bool string_smaller_eq(const indexed_substring<IndexType>& a,
+  const indexed_substring<IndexType>& b) {
+  return (string_cmp(a, b) <= 0);
+}
+
+// Compares a substring with a 0-terminated string, e.g., a splitter.
+template <typename IndexType>
+static inline bool string_smaller_eq(const indexed_substring<IndexType>& a,
+  const dsss::string b) {
+  std::size_t depth = 0;
+  while (depth < std::size_t(a.length) && a.string[depth] == b[depth]) {
+    ++depth;
+  }
+  return a[depth] <= b[depth];
+}
+
 } // namespace dsss
 
 /******************************************************************************/
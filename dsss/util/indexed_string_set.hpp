@@ -27,6 +27,8 @@ class indexed_string_set {
   using idx_string = dsss::indexed_string<IndexType>;
 
 public:
+  using index_type = IndexType;
+
   indexed_string_set() { }
 
   indexed_string_set(std::vector<dsss::char_type>&& string_data,
@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * util/indexed_substring_set.hpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "util/indexed_string.hpp"
+
+namespace dsss {
+
+// Set of substrings that are given by their position and length in a text.
+// Only substrings that exceed the local text (e.g., because they end in the
+// slice of the next PE) are stored in the set, all other substrings point into
+// the text, which must not change while the set is used.
+template <typename IndexType>
+class indexed_substring_set {
+
+  using idx_substring = dsss::indexed_substring<IndexType>;
+
+public:
+  using index_type = IndexType;
+
+  indexed_substring_set() { }
+
+  // The tail contains the characters of all substrings that start at or after
+  // tail_begin, which is the position of the tail in the text.
+  indexed_substring_set(dsss::string text, std::vector<dsss::char_type>&& tail,
+    const size_t tail_begin, std::vector<IndexType>&& positions,
+    std::vector<IndexType>&& lengths, const IndexType offset)
+  : tail_(std::move(tail)) {
+    substrings_.reserve(positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+      const size_t position = positions[i];
+      dsss::string string = (position < tail_begin) ? text + position :
+        tail_.data() + (position - tail_begin);
+      substrings_.emplace_back(
+        idx_substring { positions[i] + offset, string, lengths[i] });
+    }
+  }
+
+  indexed_substring_set(const indexed_substring_set&) = delete;
+  indexed_substring_set& operator =(const indexed_substring_set&) = delete;
+
+  // Moving a vector does not move its data, hence, the substrings stay valid.
+  indexed_substring_set(indexed_substring_set&& other) = default;
+  indexed_substring_set& operator =(indexed_substring_set&& other) = default;
+
+  idx_substring operator [](const size_t idx) const {
+    return substrings_[idx];
+  }
+
+  size_t size() const {
+    return substrings_.size();
+  }
+
+  auto begin() { return substrings_.begin(); }
+  auto end() { return substrings_.end(); }
+
+  idx_substring* strings() {
+    return substrings_.data();
+  }
+
+  // Number of characters of all substrings (without terminating 0s)
+  size_t char_count() const {
+    size_t result = 0;
+    for (const auto& substring : substrings_) { result += substring.length; }
+    return result;
+  }
+
+private:
+  std::vector<dsss::char_type> tail_;
+  std::vector<idx_substring> substrings_;
+
+}; // class indexed_substring_set
+
+} // namespace dsss
+
+/******************************************************************************/
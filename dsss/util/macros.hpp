@@ -22,4 +22,13 @@
 #define DSSS_ATTRIBUTE_PACKED
 #endif
 
+// OpenMP directives, e.g., DSSS_OMP(parallel for), which are omitted if the
+// code is compiled without OpenMP (instead of warning about unknown pragmas).
+#define DSSS_PRAGMA(x) _Pragma(#x)
+#if defined(_OPENMP)
+#define DSSS_OMP(directive) DSSS_PRAGMA(omp directive)
+#else
+#define DSSS_OMP(directive)
+#endif
+
 /******************************************************************************/
@@ -0,0 +1,101 @@
+/*******************************************************************************
+ * util/mapped_file.hpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+#include "util/string.hpp"
+
+namespace dsss {
+
+// Read-only memory mapping of a whole file. Pages are only read from the file
+// when they are accessed, hence, each PE only reads the part of the file it
+// works on. The mapping of an empty file is empty. Failing to open, stat, or
+// map the file is reported and aborts the program.
+class mapped_file {
+
+public:
+  mapped_file() { }
+
+  mapped_file(const std::string& file_name) {
+    const int32_t file_descriptor = open(file_name.c_str(), O_RDONLY);
+    if (file_descriptor < 0) { fail("Cannot open", file_name); }
+    struct stat file_stat;
+    if (fstat(file_descriptor, &file_stat) != 0) {
+      fail("Cannot stat", file_name);
+    }
+    if (file_stat.st_size > 0) {
+      void* mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED,
+                           file_descriptor, 0);
+      if (mapping == MAP_FAILED) { fail("Cannot map", file_name); }
+      data_ = static_cast<const dsss::char_type*>(mapping);
+      size_ = file_stat.st_size;
+    }
+    // The mapping remains valid after the file has been closed
+    close(file_descriptor);
+  }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator =(const mapped_file&) = delete;
+
+  mapped_file(mapped_file&& other)
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) { }
+
+  mapped_file& operator =(mapped_file&& other) {
+    if (this != &other) {
+      unmap();
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+
+  ~mapped_file() {
+    unmap();
+  }
+
+  inline const dsss::char_type* data() const {
+    return data_;
+  }
+
+  inline size_t size() const {
+    return size_;
+  }
+
+private:
+  [[noreturn]] static void fail(const char* message,
+    const std::string& file_name) {
+    std::perror((std::string(message) + " " + file_name).c_str());
+    std::abort();
+  }
+
+  void unmap() {
+    if (data_ != nullptr) {
+      munmap(const_cast<dsss::char_type*>(data_), size_);
+      data_ = nullptr;
+      size_ = 0;
+    }
+  }
+
+  const dsss::char_type* data_ = nullptr;
+  size_t size_ = 0;
+
+}; // class mapped_file
+
+} // namespace dsss
+
+/******************************************************************************/
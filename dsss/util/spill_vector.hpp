@@ -0,0 +1,150 @@
+/*******************************************************************************
+ * util/spill_vector.hpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace dsss {
+
+// Configuration of spill_vector. A memory budget of 0 disables spilling.
+struct spill_config {
+  size_t memory_budget = 0;
+  std::string scratch_directory = ".";
+}; // struct spill_config
+
+// Append-only vector that keeps at most memory_budget bytes in RAM. Whenever
+// the buffer is full, it is appended to a scratch file using one sequential
+// write. The elements can be read in chunks that fit into the memory budget.
+//
+// The scratch file gets a unique name (starting with file_name) in the
+// scratch directory and is unlinked right after it has been created, i.e., it
+// disappears even if the program does not terminate regularly. Failing to
+// create, write, or read the scratch file is reported and aborts the program.
+template <typename DataType>
+class spill_vector {
+
+public:
+  spill_vector(const spill_config& config, const std::string& file_name)
+    : capacity_(config.memory_budget / sizeof(DataType)),
+      file_name_(config.scratch_directory + "/" + file_name + "_XXXXXX") {
+    if (config.memory_budget > 0) {
+      capacity_ = std::max<size_t>(1, capacity_);
+      buffer_.reserve(capacity_);
+    }
+  }
+
+  spill_vector(const spill_vector&) = delete;
+  spill_vector& operator =(const spill_vector&) = delete;
+
+  ~spill_vector() {
+    if (file_ != nullptr) { std::fclose(file_); }
+  }
+
+  inline void emplace_back(const DataType& value) {
+    buffer_.emplace_back(value);
+    if (capacity_ > 0 && buffer_.size() == capacity_) { spill(); }
+  }
+
+  inline size_t size() const {
+    return spilled_ + buffer_.size();
+  }
+
+  inline size_t spilled() const {
+    return spilled_;
+  }
+
+  // Number of elements that fit into the memory budget (all elements, if
+  // there is no budget).
+  inline size_t chunk_size() const {
+    return (capacity_ > 0) ? capacity_ : std::max<size_t>(1, size());
+  }
+
+  // Returns the (at most count) elements starting at position begin. The
+  // spilled elements are read using one sequential read.
+  std::vector<DataType> read(const size_t begin, size_t count) const {
+    count = std::min(count, size() - std::min(begin, size()));
+    std::vector<DataType> result(count);
+    const size_t from_file =
+      std::min(count, spilled_ - std::min(begin, spilled_));
+    if (from_file > 0) {
+      if (std::fseek(file_, long(begin * sizeof(DataType)), SEEK_SET) != 0 ||
+          std::fread(result.data(), sizeof(DataType), from_file, file_) !=
+          from_file) {
+        fail("Cannot read scratch file");
+      }
+    }
+    if (count > from_file) {
+      std::copy_n(buffer_.begin() + (begin + from_file - spilled_),
+                  count - from_file, result.begin() + from_file);
+    }
+    return result;
+  }
+
+  // Moves all elements into one vector (with the given additional capacity)
+  // and empties this vector.
+  std::vector<DataType> release(const size_t additional_capacity = 0) {
+    std::vector<DataType> result =
+      (spilled_ == 0) ? std::move(buffer_) : read(0, size());
+    result.reserve(result.size() + additional_capacity);
+    clear();
+    return result;
+  }
+
+  // Removes all elements. The scratch file is truncated and reused.
+  void clear() {
+    buffer_.clear();
+    if (file_ != nullptr) {
+      std::fflush(file_);
+      if (ftruncate(fileno(file_), 0) != 0) {
+        fail("Cannot truncate scratch file");
+      }
+      std::rewind(file_);
+    }
+    spilled_ = 0;
+  }
+
+private:
+  void spill() {
+    if (file_ == nullptr) {
+      const int fd = mkstemp(&file_name_[0]);
+      if (fd < 0 || (file_ = fdopen(fd, "w+b")) == nullptr) {
+        fail("Cannot create scratch file");
+      }
+      std::remove(file_name_.c_str());
+    }
+    if (std::fseek(file_, 0, SEEK_END) != 0 ||
+        std::fwrite(buffer_.data(), sizeof(DataType), buffer_.size(), file_) !=
+        buffer_.size()) {
+      fail("Cannot write scratch file");
+    }
+    spilled_ += buffer_.size();
+    buffer_.clear();
+  }
+
+  [[noreturn]] void fail(const char* message) const {
+    std::perror((std::string(message) + " " + file_name_).c_str());
+    std::abort();
+  }
+
+  size_t capacity_;
+  std::string file_name_;
+  std::vector<DataType> buffer_;
+  size_t spilled_ = 0;
+  std::FILE* file_ = nullptr;
+
+}; // class spill_vector
+
+} // namespace dsss
+
+/******************************************************************************/
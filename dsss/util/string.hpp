@@ -10,33 +10,184 @@
 
 #include <cstdint>
 #include <iostream>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace dsss {
 
 using char_type = unsigned char;
 using string = char_type*;
 
+// The local slice of a text that is distributed among the PEs. The halo
+// contains the characters that follow the slice (which may belong to multiple
+// PEs). It is empty unless requested and has the same size on all PEs, i.e.,
+// characters beyond the end of the text are 0.
 struct distributed_string {
   size_t offset;
   std::vector<dsss::char_type> string;
+  std::vector<dsss::char_type> halo = { };
 }; // struct distributed_string
 
-static inline size_t string_length(const dsss::string str) {
-  auto _str = str;
-  while (*_str != static_cast<dsss::char_type>(0)) { ++_str; }
-  return _str - str;
+// Like distributed_string, but the slice is not owned, e.g., because it is
+// part of a memory-mapped file (see mpi::map_string). The halo is owned, as it
+// is padded beyond the end of the text.
+struct distributed_string_view {
+  size_t offset;
+  std::basic_string_view<dsss::char_type> string;
+  std::vector<dsss::char_type> halo = { };
+}; // struct distributed_string_view
+
+// Copies the slice for algorithms that modify the text. Owning strings are
+// passed through, such that generic code can use both.
+static inline distributed_string to_distributed_string(
+  const distributed_string_view& view) {
+  return distributed_string { view.offset,
+    std::vector<dsss::char_type>(view.string.begin(), view.string.end()),
+    view.halo };
 }
 
-static inline int64_t string_cmp(const dsss::string a, const dsss::string b) {
+static inline distributed_string to_distributed_string(
+  distributed_string&& input) {
+  return std::move(input);
+}
+
+// The string functions below compare and scan blocks of simd_bytes characters
+// using SSE2 or AVX2 (whichever is available at compile time, e.g., with
+// -march=native). A block may extend beyond the end of a string, which is
+// safe as long as it does not cross a page boundary, as the page containing
+// the first character of the block is readable. Blocks that would cross a
+// page boundary are processed character by character. AddressSanitizer
+// reports these reads, hence, the characters are always processed one by one
+// when it is enabled.
+#if defined(__SANITIZE_ADDRESS__)
+#define DSSS_STRING_SANITIZED
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define DSSS_STRING_SANITIZED
+#endif
+#endif
+
+#if defined(DSSS_STRING_SANITIZED)
+static constexpr size_t simd_bytes = 0;
+#elif defined(__AVX2__)
+#define DSSS_STRING_SIMD
+static constexpr size_t simd_bytes = 32;
+#elif defined(__SSE2__)
+#define DSSS_STRING_SIMD
+static constexpr size_t simd_bytes = 16;
+#else
+static constexpr size_t simd_bytes = 0;
+#endif
+
+#if defined(DSSS_STRING_SIMD)
+static constexpr std::uintptr_t simd_page_size = 4096;
+
+static inline bool simd_block_readable(const dsss::string str) {
+  return (reinterpret_cast<std::uintptr_t>(str) & (simd_page_size - 1)) <=
+    simd_page_size - simd_bytes;
+}
+
+// Bit i is set if str[i] is the end of the string.
+static inline std::uint32_t simd_end_mask(const dsss::string str) {
+#if defined(__AVX2__)
+  const __m256i block =
+    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str));
+  return std::uint32_t(_mm256_movemask_epi8(
+    _mm256_cmpeq_epi8(block, _mm256_setzero_si256())));
+#else
+  const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str));
+  return std::uint32_t(_mm_movemask_epi8(
+    _mm_cmpeq_epi8(block, _mm_setzero_si128())));
+#endif
+}
+
+// Bit i is set if a[i] and b[i] differ or if a[i] is the end of the string.
+static inline std::uint32_t simd_mismatch_mask(const dsss::string a,
+  const dsss::string b) {
+#if defined(__AVX2__)
+  const __m256i block_a =
+    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+  const __m256i block_b =
+    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+  const std::uint32_t equal = std::uint32_t(_mm256_movemask_epi8(
+    _mm256_cmpeq_epi8(block_a, block_b)));
+  const std::uint32_t end = std::uint32_t(_mm256_movemask_epi8(
+    _mm256_cmpeq_epi8(block_a, _mm256_setzero_si256())));
+#else
+  const __m128i block_a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+  const __m128i block_b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+  const std::uint32_t equal = std::uint32_t(_mm_movemask_epi8(
+    _mm_cmpeq_epi8(block_a, block_b))) | 0xFFFF0000;
+  const std::uint32_t end = std::uint32_t(_mm_movemask_epi8(
+    _mm_cmpeq_epi8(block_a, _mm_setzero_si128())));
+#endif
+  return ~equal | end;
+}
+#endif
+
+static inline size_t string_length(const dsss::string str) {
+  size_t length = 0;
+#if defined(DSSS_STRING_SIMD)
+  while (true) {
+    if (simd_block_readable(str + length)) {
+      const std::uint32_t end = simd_end_mask(str + length);
+      if (end != 0) { return length + __builtin_ctz(end); }
+      length += simd_bytes;
+    } else if (str[length] == static_cast<dsss::char_type>(0)) {
+      return length;
+    } else {
+      ++length;
+    }
+  }
+#else
+  while (str[length] != static_cast<dsss::char_type>(0)) { ++length; }
+  return length;
+#endif
+}
 
-  auto _a = a;
-  auto _b = b;
-  while (*_a != static_cast<dsss::char_type>(0) && *_a == *_b) {
-    ++_a;
-    ++_b;
+// Returns the length of the longest common prefix of both strings.
+static inline size_t string_lcp(const dsss::string a, const dsss::string b) {
+  size_t lcp = 0;
+#if defined(DSSS_STRING_SIMD)
+  while (true) {
+    if (simd_block_readable(a + lcp) && simd_block_readable(b + lcp)) {
+      const std::uint32_t mismatch = simd_mismatch_mask(a + lcp, b + lcp);
+      if (mismatch != 0) { return lcp + __builtin_ctz(mismatch); }
+      lcp += simd_bytes;
+    } else if (a[lcp] == static_cast<dsss::char_type>(0) ||
+               a[lcp] != b[lcp]) {
+      return lcp;
+    } else {
+      ++lcp;
+    }
+  }
+#else
+  while (a[lcp] != static_cast<dsss::char_type>(0) && a[lcp] == b[lcp]) {
+    ++lcp;
   }
-  return (*_a - *_b);
+  return lcp;
+#endif
+}
+
+// Compares both strings and also returns the length of their longest common
+// prefix (for LCP-aware callers).
+static inline int64_t string_cmp(const dsss::string a, const dsss::string b,
+  size_t& lcp) {
+
+  lcp = string_lcp(a, b);
+  return (a[lcp] - b[lcp]);
+}
+
+static inline int64_t string_cmp(const dsss::string a, const dsss::string b) {
+  size_t lcp;
+  return string_cmp(a, b, lcp);
 }
 
 static inline bool string_eq(const dsss::string a, const dsss::string b) {
@@ -49,6 +200,12 @@ static inline bool string_smaller_eq(const dsss::string a,
   return (string_cmp(a, b) <= 0);
 }
 
+static inline bool string_smaller_eq(const dsss::string a,
+  const dsss::string b, size_t& lcp) {
+
+  return (string_cmp(a, b, lcp) <= 0);
+}
+
 static inline void string_print(const dsss::string str) {
   auto _str = str;
   while (*_str != static_cast<dsss::char_type>(0)) {
@@ -0,0 +1,63 @@
+/*******************************************************************************
+ * tests/mpi/checkpoint_test.cpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include "gtest/gtest.h"
+#include <mpi.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "mpi/checkpoint.hpp"
+#include "mpi/environment.hpp"
+
+#include "util/uint_types.hpp"
+
+namespace dsss::tests::mpi {
+
+TEST(checkpoint, write_and_read) {
+  dsss::mpi::environment env;
+  dsss::mpi::checkpoint_config config;
+  config.directory = ".";
+  const std::string file_name = config.path("checkpoint_test");
+
+  // Blocks of different sizes (one PE has an empty block)
+  std::vector<std::uint32_t> first;
+  for (std::size_t i = 0; i < 100 * env.rank(); ++i) {
+    first.emplace_back(i * env.size() + env.rank());
+  }
+  std::vector<dsss::uint40> second;
+  for (std::size_t i = 0; i < 50 + env.rank(); ++i) {
+    second.emplace_back(dsss::uint40((i << 33) + env.rank()));
+  }
+  {
+    dsss::mpi::checkpoint_writer writer(file_name, 42, env);
+    writer.write(first);
+    writer.write(second);
+  }
+
+  {
+    dsss::mpi::checkpoint_reader reader(file_name, env);
+    ASSERT_TRUE(reader.valid());
+    ASSERT_EQ(reader.tag(), 42ULL);
+    auto read_first = reader.read<std::uint32_t>();
+    auto read_second = reader.read<dsss::uint40>();
+    ASSERT_EQ(first, read_first);
+    ASSERT_EQ(second.size(), read_second.size());
+    for (std::size_t i = 0; i < second.size(); ++i) {
+      ASSERT_EQ(std::uint64_t(second[i]), std::uint64_t(read_second[i]));
+    }
+  }
+  dsss::mpi::remove_checkpoint(file_name, env);
+
+  dsss::mpi::checkpoint_reader missing_reader(file_name, env);
+  ASSERT_FALSE(missing_reader.valid());
+}
+
+} // namespace dsss::tests::mpi
+
+/******************************************************************************/
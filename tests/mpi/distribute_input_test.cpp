@@ -8,12 +8,16 @@
 #include "gtest/gtest.h"
 
 #include <fstream>
+#include <limits>
 #include <mpi.h>
+#include <vector>
 
 #include "mpi/allgather.hpp"
 #include "mpi/distribute_input.hpp"
 #include "mpi/environment.hpp"
 
+#include "util/mapped_file.hpp"
+
 namespace dsss::tests::mpi {
 
 TEST(distribute_string, the_three_brothers_full) {
@@ -45,6 +49,57 @@ TEST(distribute_string, the_three_brothers_full) {
   }
 }
 
+TEST(distribute_string, the_three_brothers_halo) {
+  dsss::mpi::environment env;
+
+  std::ifstream stream("test_data/the_three_brothers.txt");
+  stream.ignore(std::numeric_limits<std::streamsize>::max());
+  std::size_t file_size = stream.gcount();
+  stream.clear();
+  stream.seekg(0, std::ios::beg);
+  std::vector<char> text(file_size);
+  stream.read(text.data(), file_size);
+  stream.close();
+
+  // The halo may be larger than the slices (and exceed the end of the text)
+  for (std::size_t halo_size : { std::size_t(0), std::size_t(7),
+                                 file_size / env.size() + 3, file_size }) {
+    auto local_slice = dsss::mpi::distribute_string(
+      "test_data/the_three_brothers.txt", 0, halo_size, env);
+    auto full_slice = dsss::mpi::distribute_string(
+      "test_data/the_three_brothers.txt", 0, env);
+    ASSERT_EQ(full_slice.offset, local_slice.offset);
+    ASSERT_EQ(full_slice.string, local_slice.string);
+    ASSERT_EQ(halo_size, local_slice.halo.size());
+
+    const std::size_t halo_offset =
+      local_slice.offset + local_slice.string.size();
+    for (std::size_t i = 0; i < halo_size; ++i) {
+      const char expected = (halo_offset + i < file_size) ?
+        text[halo_offset + i] : char(0);
+      ASSERT_EQ(expected, char(local_slice.halo[i])) << "i=" << i;
+    }
+  }
+}
+
+TEST(distribute_string, the_three_brothers_mapped) {
+  dsss::mpi::environment env;
+
+  dsss::mapped_file file("test_data/the_three_brothers.txt");
+  for (std::size_t max_size : { std::size_t(0), std::size_t(1000) }) {
+    auto local_slice = dsss::mpi::distribute_string(
+      "test_data/the_three_brothers.txt", max_size, 100, env);
+    auto mapped_slice = dsss::mpi::map_string(file, max_size, 100, env);
+
+    ASSERT_EQ(local_slice.offset, mapped_slice.offset);
+    ASSERT_EQ(local_slice.string.size(), mapped_slice.string.size());
+    for (std::size_t i = 0; i < local_slice.string.size(); ++i) {
+      ASSERT_EQ(local_slice.string[i], mapped_slice.string[i]);
+    }
+    ASSERT_EQ(local_slice.halo, mapped_slice.halo);
+  }
+}
+
 } // namespace dsss::tests::mpi
 
 /******************************************************************************/
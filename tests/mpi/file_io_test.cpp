@@ -0,0 +1,162 @@
+/*******************************************************************************
+ * tests/mpi/file_io_test.cpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include "gtest/gtest.h"
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "mpi/allgather.hpp"
+#include "mpi/distribute_input.hpp"
+#include "mpi/environment.hpp"
+#include "mpi/file_io.hpp"
+#include "mpi/scan.hpp"
+
+#include "util/uint_types.hpp"
+
+namespace dsss::tests::mpi {
+
+template <typename DataType>
+void check_write_and_read(const std::size_t base_size,
+  const dsss::mpi::io_hints& hints) {
+  dsss::mpi::environment env;
+
+  // Blocks of different sizes (the first PE may have an empty block)
+  std::vector<DataType> local_data;
+  for (std::size_t i = 0; i < base_size * env.rank() + 3; ++i) {
+    local_data.emplace_back(DataType((i * 7919) + env.rank()));
+  }
+  auto all_data = dsss::mpi::allgatherv(local_data, env);
+
+  dsss::mpi::write_data(local_data, "file_io_test.bin", hints, env);
+  auto read_data = dsss::mpi::read_data<DataType>("file_io_test.bin", hints,
+                                                  env);
+  auto all_read_data = dsss::mpi::allgatherv(read_data, env);
+
+  ASSERT_EQ(all_data.size(), all_read_data.size());
+  for (std::size_t i = 0; i < all_data.size(); ++i) {
+    ASSERT_EQ(std::uint64_t(all_data[i]), std::uint64_t(all_read_data[i]))
+      << "i=" << i;
+  }
+}
+
+TEST(file_io, write_and_read) {
+  dsss::mpi::environment env;
+  dsss::mpi::io_hints hints;
+  check_write_and_read<std::uint32_t>(1000, hints);
+  // Shorter data overwrites the file, which is truncated
+  check_write_and_read<dsss::uint40>(10, hints);
+  hints.cb_nodes = 1;
+  hints.cb_buffer_size = 1024;
+  check_write_and_read<std::uint64_t>(100, hints);
+  hints.collective_buffering = false;
+  check_write_and_read<std::uint8_t>(0, hints);
+  env.barrier();
+  if (env.rank() == 0) {
+    std::remove("file_io_test.bin");
+  }
+}
+
+TEST(file_io, split_data) {
+  dsss::mpi::environment env;
+
+  std::vector<dsss::uint40> local_data;
+  for (std::size_t i = 0; i < 100 * env.rank() + 7; ++i) {
+    local_data.emplace_back(dsss::uint40((i << 20) + env.rank()));
+  }
+  auto all_data = dsss::mpi::allgatherv(local_data, env);
+  dsss::mpi::write_split_data(local_data, "file_io_test.split", env);
+
+  // Same number of PEs: same distribution as written
+  auto read_data = dsss::mpi::read_split_data<dsss::uint40>(
+    "file_io_test.split", env);
+  ASSERT_EQ(local_data.size(), read_data.size());
+  for (std::size_t i = 0; i < local_data.size(); ++i) {
+    ASSERT_EQ(std::uint64_t(local_data[i]), std::uint64_t(read_data[i]));
+  }
+
+  // Fewer PEs: the data is distributed evenly
+  MPI_Comm half_comm;
+  const std::int32_t half = std::max(1, env.size() / 2);
+  MPI_Comm_split(env.communicator(), env.rank() < half ? 0 : 1, env.rank(),
+                 &half_comm);
+  if (env.rank() < half && half < env.size()) {
+    dsss::mpi::environment half_env(half_comm);
+    auto half_data = dsss::mpi::read_split_data<dsss::uint40>(
+      "file_io_test.split", half_env);
+    auto all_half_data = dsss::mpi::allgatherv(half_data, half_env);
+    ASSERT_EQ(all_data.size(), all_half_data.size());
+    for (std::size_t i = 0; i < all_data.size(); ++i) {
+      ASSERT_EQ(std::uint64_t(all_data[i]), std::uint64_t(all_half_data[i]));
+    }
+  }
+  MPI_Comm_free(&half_comm);
+
+  env.barrier();
+  std::remove(dsss::mpi::split_manifest::file_name("file_io_test.split",
+                                                   env.rank()).c_str());
+  if (env.rank() == 0) {
+    std::remove("file_io_test.split");
+  }
+}
+
+TEST(file_io, split_strings) {
+  dsss::mpi::environment env;
+
+  // Strings of different lengths, some of them empty
+  std::vector<dsss::char_type> local_chars;
+  for (std::size_t i = 0; i < 20 * (env.rank() + 1); ++i) {
+    for (std::size_t j = 0; j < (i * 7 + env.rank()) % 13; ++j) {
+      local_chars.emplace_back(dsss::char_type('a' + (i + j) % 26));
+    }
+    local_chars.emplace_back(dsss::char_type(0));
+  }
+  auto all_chars = dsss::mpi::allgatherv(local_chars, env);
+  dsss::mpi::write_split_data(local_chars, "file_io_test.split", env);
+
+  // Same number of PEs: same distribution as written
+  auto read_strings = dsss::mpi::read_split_strings("file_io_test.split",
+                                                    env);
+  ASSERT_EQ(local_chars, read_strings.string);
+  std::size_t local_size = local_chars.size();
+  ASSERT_EQ(dsss::mpi::ex_prefix_sum(local_size, env), read_strings.offset);
+
+  // Fewer PEs: each PE gets complete strings, which start at its offset
+  MPI_Comm half_comm;
+  const std::int32_t half = std::max(1, env.size() / 2);
+  MPI_Comm_split(env.communicator(), env.rank() < half ? 0 : 1, env.rank(),
+                 &half_comm);
+  if (env.rank() < half && half < env.size()) {
+    dsss::mpi::environment half_env(half_comm);
+    auto half_strings = dsss::mpi::read_split_strings("file_io_test.split",
+                                                      half_env);
+    auto& chars = half_strings.string;
+    if (!chars.empty()) {
+      ASSERT_EQ(dsss::char_type(0), chars.back());
+      ASSERT_TRUE(half_strings.offset == 0 ||
+                  all_chars[half_strings.offset - 1] == 0);
+    }
+    auto all_half_chars = dsss::mpi::allgatherv(chars, half_env);
+    ASSERT_EQ(all_chars, all_half_chars);
+  }
+  MPI_Comm_free(&half_comm);
+
+  env.barrier();
+  std::remove(dsss::mpi::split_manifest::file_name("file_io_test.split",
+                                                   env.rank()).c_str());
+  if (env.rank() == 0) {
+    std::remove("file_io_test.split");
+  }
+}
+
+} // namespace dsss::tests::mpi
+
+/******************************************************************************/
@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * tests/mpi/packed_data_test.cpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include "gtest/gtest.h"
+#include <mpi.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "mpi/allgather.hpp"
+#include "mpi/environment.hpp"
+#include "mpi/packed_data.hpp"
+
+#include "util/uint_types.hpp"
+
+namespace dsss::tests::mpi {
+
+template <typename DataType>
+void check_packed_data(const std::uint64_t max_value) {
+  dsss::mpi::environment env;
+
+  // Blocks of different sizes, such that entries span two words.
+  std::vector<DataType> local_data;
+  for (std::size_t i = 0; i < 1000 + (17 * env.rank()); ++i) {
+    std::uint64_t value = (i * 0x9E3779B97F4A7C15ULL) + env.rank();
+    if (max_value < ~std::uint64_t(0)) {
+      value %= (max_value + 1);
+    }
+    local_data.emplace_back(value);
+  }
+  if (env.rank() == 0) {
+    local_data.emplace_back(max_value);
+  }
+  auto all_data = dsss::mpi::allgatherv(local_data, env);
+
+  dsss::mpi::write_packed_data(local_data, "packed_data_test.bin",
+                               dsss::mpi::io_hints(), env);
+  auto read_data = dsss::mpi::read_packed_data<DataType>(
+    "packed_data_test.bin", dsss::mpi::io_hints(), env);
+  auto all_read_data = dsss::mpi::allgatherv(read_data, env);
+  env.barrier();
+  if (env.rank() == 0) {
+    std::remove("packed_data_test.bin");
+  }
+
+  ASSERT_EQ(all_data.size(), all_read_data.size());
+  for (std::size_t i = 0; i < all_data.size(); ++i) {
+    ASSERT_EQ(std::uint64_t(all_data[i]), std::uint64_t(all_read_data[i]))
+      << "i=" << i;
+  }
+}
+
+TEST(packed_data, correctness) {
+  check_packed_data<std::uint32_t>(1);
+  check_packed_data<std::uint32_t>(1000);
+  check_packed_data<dsss::uint40>(123456789012ULL);
+  check_packed_data<std::uint64_t>(~std::uint64_t(0));
+}
+
+} // namespace dsss::tests::mpi
+
+/******************************************************************************/
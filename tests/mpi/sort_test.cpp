@@ -0,0 +1,201 @@
+/*******************************************************************************
+ * tests/mpi/sort_test.cpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include "gtest/gtest.h"
+#include <mpi.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "mpi/allgather.hpp"
+#include "mpi/allreduce.hpp"
+#include "mpi/distribute_data.hpp"
+#include "mpi/environment.hpp"
+#include "mpi/scan.hpp"
+#include "mpi/sort.hpp"
+
+#include "util/uint_types.hpp"
+
+namespace dsss::tests::mpi {
+
+void check_sort(const std::size_t local_size, const std::uint64_t max_value,
+  const bool balanced = false) {
+  dsss::mpi::environment env;
+
+  // The first PE has less data than the others
+  std::mt19937_64 generator(env.rank() + local_size);
+  std::uniform_int_distribution<std::uint64_t> distribution(0, max_value);
+  std::vector<std::uint64_t> local_data;
+  for (std::size_t i = 0; i < local_size * (env.rank() > 0 ? 2 : 1); ++i) {
+    local_data.emplace_back(distribution(generator));
+  }
+  auto all_data = dsss::mpi::allgatherv(local_data, env);
+  std::sort(all_data.begin(), all_data.end());
+
+  if (balanced) {
+    dsss::mpi::balanced_sort(local_data, std::less<std::uint64_t>(), env);
+  } else {
+    dsss::mpi::sort(local_data, std::less<std::uint64_t>(), env);
+  }
+  auto all_sorted_data = dsss::mpi::allgatherv(local_data, env);
+  ASSERT_EQ(all_data, all_sorted_data);
+
+  if (balanced) {
+    // Same distribution as computed by distribute_data
+    auto distributed_data = dsss::mpi::distribute_data(local_data, env);
+    ASSERT_EQ(local_data.size(), distributed_data.size());
+  } else {
+    // Equal elements end up on the same PE
+    std::size_t local_n = local_data.size();
+    auto offset = dsss::mpi::ex_prefix_sum(local_n, env);
+    if (offset > 0 && local_n > 0) {
+      ASSERT_NE(all_sorted_data[offset - 1], all_sorted_data[offset]);
+    }
+  }
+}
+
+TEST(sort, correctness) {
+  // Always use sample sort
+  const std::size_t threshold = dsss::mpi::hypercube_sort_threshold;
+  dsss::mpi::hypercube_sort_threshold = 0;
+  check_sort(0, 100);
+  check_sort(10, 100);
+  check_sort(1000, std::numeric_limits<std::uint64_t>::max());
+  // Large enough to sort and merge using multiple threads
+  check_sort(100000, 1000);
+  check_sort(100000, std::numeric_limits<std::uint64_t>::max());
+  dsss::mpi::hypercube_sort_threshold = threshold;
+}
+
+TEST(sort, hypercube_quicksort) {
+  const std::size_t threshold = dsss::mpi::hypercube_sort_threshold;
+  dsss::mpi::hypercube_sort_threshold =
+    std::numeric_limits<std::size_t>::max() / 1024;
+  check_sort(0, 100);
+  check_sort(1, 100);
+  check_sort(10, 0);
+  check_sort(10, 3);
+  check_sort(100, 3);
+  check_sort(1000, std::numeric_limits<std::uint64_t>::max());
+  dsss::mpi::hypercube_sort_threshold = threshold;
+}
+
+TEST(sort, balanced) {
+  check_sort(0, 100, true);
+  check_sort(1, 100, true);
+  check_sort(10, 0, true);
+  check_sort(10, 3, true);
+  check_sort(1000, std::numeric_limits<std::uint64_t>::max(), true);
+  check_sort(100000, 1000, true);
+}
+
+// Elements with few different keys and their origin, which is used to check
+// the stability. A payload makes the elements wider than (key, slot) pairs,
+// such that only these pairs are moved during the local sorting.
+template <std::size_t PayloadSize>
+struct keyed_element {
+  std::int32_t signed_key;
+  dsss::uint40 unsigned_key;
+  std::uint64_t origin;
+  std::array<std::uint8_t, PayloadSize> payload;
+};
+
+template <std::size_t PayloadSize>
+void check_sort_by_key(const std::size_t local_size) {
+  using element = keyed_element<PayloadSize>;
+  dsss::mpi::environment env;
+
+  std::mt19937_64 generator(env.rank() + local_size);
+  std::uniform_int_distribution<std::int32_t> signed_distribution(-2, 2);
+  std::uniform_int_distribution<std::uint64_t> unsigned_distribution(0, 3);
+  std::vector<element> local_data;
+  for (std::size_t i = 0; i < local_size * (env.rank() % 3); ++i) {
+    element e;
+    e.signed_key = signed_distribution(generator);
+    e.unsigned_key = dsss::uint40(unsigned_distribution(generator) << 33);
+    e.origin = (std::uint64_t(env.rank()) << 32) + i;
+    e.payload.fill(std::uint8_t(i));
+    local_data.emplace_back(e);
+  }
+  std::size_t local_n = local_data.size();
+  const std::size_t total_size = dsss::mpi::allreduce_sum(local_n, env);
+
+  auto key = [](const element& e) {
+    return std::make_tuple(e.signed_key, e.unsigned_key);
+  };
+  dsss::mpi::sort_by_key(local_data, key, env);
+  auto all_sorted_data = dsss::mpi::allgatherv(local_data, env);
+  ASSERT_EQ(total_size, all_sorted_data.size());
+  for (std::size_t i = 1; i < all_sorted_data.size(); ++i) {
+    const auto& a = all_sorted_data[i - 1];
+    const auto& b = all_sorted_data[i];
+    const auto a_key = std::make_tuple(a.signed_key,
+                                       std::uint64_t(a.unsigned_key));
+    const auto b_key = std::make_tuple(b.signed_key,
+                                       std::uint64_t(b.unsigned_key));
+    ASSERT_LE(a_key, b_key) << "i=" << i;
+    if (a_key == b_key) { ASSERT_LT(a.origin, b.origin) << "i=" << i; }
+    if constexpr (PayloadSize > 0) {
+      ASSERT_EQ(std::uint8_t(b.origin), b.payload.back());
+    }
+  }
+}
+
+TEST(sort, sort_by_key) {
+  check_sort_by_key<0>(0);
+  check_sort_by_key<0>(10);
+  check_sort_by_key<0>(10000);
+  check_sort_by_key<64>(10);
+  check_sort_by_key<64>(10000);
+  // Enough elements to sort them locally using multiple threads
+  check_sort_by_key<0>(100000);
+  check_sort_by_key<64>(100000);
+
+  // Integer keys, including the extreme values
+  dsss::mpi::environment env;
+  std::vector<std::int64_t> local_data = {
+    std::numeric_limits<std::int64_t>::max(), -1, 0,
+    std::numeric_limits<std::int64_t>::min(), env.rank() - 2 };
+  auto all_data = dsss::mpi::allgatherv(local_data, env);
+  std::sort(all_data.begin(), all_data.end());
+  dsss::mpi::sort_by_key(local_data, [](const std::int64_t x) { return x; },
+    env);
+  ASSERT_EQ(all_data, dsss::mpi::allgatherv(local_data, env));
+}
+
+TEST(sort, multiway_merge) {
+  std::mt19937_64 generator(42);
+  std::uniform_int_distribution<std::uint64_t> distribution(0, 1000);
+
+  // Runs of different sizes, including empty ones
+  std::vector<std::size_t> run_begins = { 0 };
+  std::vector<std::uint64_t> data;
+  for (std::size_t run = 0; run < 9; ++run) {
+    const std::size_t run_size = (run % 3 == 1) ? 0 : 50000 * run;
+    for (std::size_t i = 0; i < run_size; ++i) {
+      data.emplace_back(distribution(generator));
+    }
+    std::sort(data.begin() + run_begins.back(), data.end());
+    run_begins.emplace_back(data.size());
+  }
+
+  auto merged = dsss::mpi::multiway_merge(data, run_begins,
+    std::less<std::uint64_t>());
+  std::sort(data.begin(), data.end());
+  ASSERT_EQ(data, merged);
+}
+
+} // namespace dsss::tests::mpi
+
+/******************************************************************************/
@@ -0,0 +1,107 @@
+/*******************************************************************************
+ * tests/string_sorting/multiset_hash.cpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "util/fingerprint.hpp"
+#include "util/string.hpp"
+
+namespace dsss::tests::string_sorting {
+
+using strings_type = std::vector<std::vector<dsss::char_type>>;
+
+std::uint64_t multiset_hash(strings_type& strings, const std::uint64_t base,
+  const std::uint64_t z) {
+  dsss::string_multiset_hash hash(base, z);
+  for (auto& str : strings) {
+    hash.add(str.data());
+  }
+  return hash.value();
+}
+
+strings_type random_strings(std::mt19937_64& generator) {
+  std::uniform_int_distribution<std::size_t> length_distribution(0, 20);
+  std::uniform_int_distribution<std::uint32_t> char_distribution(1, 3);
+  strings_type strings(100);
+  for (auto& str : strings) {
+    str.resize(length_distribution(generator));
+    for (auto& c : str) { c = char_distribution(generator); }
+    str.emplace_back(0);
+  }
+  return strings;
+}
+
+TEST(string_multiset_hash, permutation) {
+  std::mt19937_64 generator(42);
+  for (std::size_t i = 0; i < 100; ++i) {
+    const std::uint64_t base =
+      256 + generator() % (dsss::mersenne_61::prime - 256);
+    const std::uint64_t z = generator() % dsss::mersenne_61::prime;
+    auto strings = random_strings(generator);
+    const std::uint64_t hash = multiset_hash(strings, base, z);
+
+    std::shuffle(strings.begin(), strings.end(), generator);
+    ASSERT_EQ(hash, multiset_hash(strings, base, z));
+
+    // Hashes of parts of the multiset are combined (as done for the PEs)
+    dsss::string_multiset_hash first(base, z);
+    dsss::string_multiset_hash second(base, z);
+    for (std::size_t j = 0; j < strings.size(); ++j) {
+      (j < i ? first : second).add(strings[j].data());
+    }
+    dsss::string_multiset_hash combined(base, z);
+    combined.combine(second.value());
+    combined.combine(first.value());
+    ASSERT_EQ(hash, combined.value());
+  }
+}
+
+TEST(string_multiset_hash, different_multisets) {
+  std::mt19937_64 generator(42);
+  for (std::size_t i = 0; i < 100; ++i) {
+    const std::uint64_t base =
+      256 + generator() % (dsss::mersenne_61::prime - 256);
+    const std::uint64_t z = generator() % dsss::mersenne_61::prime;
+    auto strings = random_strings(generator);
+    strings[0] = { 1, 2, 3, 0 };
+    strings[1] = { 3, 2, 1, 0 };
+    const std::uint64_t hash = multiset_hash(strings, base, z);
+
+    // Changing one character
+    auto changed = strings;
+    changed[i % changed.size()].back() = 1;
+    changed[i % changed.size()].emplace_back(0);
+    ASSERT_NE(hash, multiset_hash(changed, base, z));
+    changed = strings;
+    changed[0][i % 3] = 4;
+    ASSERT_NE(hash, multiset_hash(changed, base, z));
+
+    // Swapping characters between strings, i.e., the multiset of characters
+    // remains the same
+    auto swapped = strings;
+    std::swap(swapped[0][0], swapped[1][0]);
+    ASSERT_NE(hash, multiset_hash(swapped, base, z));
+
+    // Removing a string, or adding the empty string
+    auto removed = strings;
+    removed.pop_back();
+    ASSERT_NE(hash, multiset_hash(removed, base, z));
+    auto added = strings;
+    added.push_back({ 0 });
+    ASSERT_NE(hash, multiset_hash(added, base, z));
+  }
+}
+
+} // namespace dsss::tests::string_sorting
+
+/******************************************************************************/
@@ -0,0 +1,99 @@
+/*******************************************************************************
+ * tests/string_sorting/string_comparison.cpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <random>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+#include "util/string.hpp"
+
+namespace dsss::tests::string_sorting {
+
+std::size_t naive_lcp(const dsss::string a, const dsss::string b) {
+  std::size_t lcp = 0;
+  while (a[lcp] != 0 && a[lcp] == b[lcp]) { ++lcp; }
+  return lcp;
+}
+
+void check_strings(const dsss::string a, const dsss::string b) {
+  const std::size_t expected_lcp = naive_lcp(a, b);
+  const std::int64_t expected_cmp = a[expected_lcp] - b[expected_lcp];
+  std::size_t lcp = 0;
+  ASSERT_EQ(expected_cmp, dsss::string_cmp(a, b, lcp));
+  ASSERT_EQ(expected_lcp, lcp);
+  ASSERT_EQ(expected_lcp, dsss::string_lcp(a, b));
+  ASSERT_EQ(expected_cmp, dsss::string_cmp(a, b));
+  ASSERT_EQ(expected_cmp <= 0, dsss::string_smaller_eq(a, b));
+  ASSERT_EQ(naive_lcp(a, a), dsss::string_length(a));
+}
+
+TEST(string_comparison, random_strings) {
+  std::mt19937_64 generator(42);
+  std::uniform_int_distribution<std::size_t> length_distribution(0, 100);
+  std::uniform_int_distribution<std::uint32_t> char_distribution(1, 3);
+  for (std::size_t i = 0; i < 10000; ++i) {
+    // Strings with long common prefixes and different offsets (alignments)
+    std::vector<dsss::char_type> a(i % 64, 1);
+    std::vector<dsss::char_type> b((i / 64) % 64, 1);
+    const std::size_t length = length_distribution(generator);
+    const std::size_t a_begin = a.size();
+    const std::size_t b_begin = b.size();
+    for (std::size_t j = 0; j < length; ++j) {
+      const dsss::char_type c = char_distribution(generator);
+      a.emplace_back(c);
+      b.emplace_back((j + 1 < length || i % 2 == 0) ? c :
+        char_distribution(generator));
+    }
+    a.emplace_back(0);
+    b.resize(b_begin + length_distribution(generator) % (length + 1));
+    b.emplace_back(0);
+    check_strings(a.data() + a_begin, b.data() + b_begin);
+    check_strings(b.data() + b_begin, a.data() + a_begin);
+  }
+}
+
+TEST(string_comparison, page_boundaries) {
+  // Two pages, of which only the first one is readable. The strings end at
+  // the end of the first page, i.e., reading beyond the strings would fail.
+  const std::size_t page_size = sysconf(_SC_PAGESIZE);
+  void* mapping = mmap(nullptr, 2 * page_size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(MAP_FAILED, mapping);
+  ASSERT_EQ(0, mprotect(static_cast<char*>(mapping) + page_size, page_size,
+                        PROT_NONE));
+  auto page = static_cast<dsss::char_type*>(mapping);
+  std::vector<dsss::char_type> other(page_size, 'a');
+  other.back() = 0;
+
+  for (std::size_t length = 0; length < 200; ++length) {
+    std::fill_n(page, page_size, 'a');
+    page[page_size - 1] = 0;
+    const dsss::string str = page + page_size - 1 - length;
+    const dsss::string other_str = other.data() + page_size - 1 - length;
+    ASSERT_EQ(length, dsss::string_length(str));
+    check_strings(str, other_str);
+    check_strings(other_str, str);
+    check_strings(str, str);
+    if (length > 0) {
+      str[length / 2] = 'b';
+      check_strings(str, other_str);
+      check_strings(other_str, str);
+      // Both strings end at the page boundary
+      check_strings(str, page + page_size - 1);
+    }
+  }
+  munmap(mapping, 2 * page_size);
+}
+
+} // namespace dsss::tests::string_sorting
+
+/******************************************************************************/
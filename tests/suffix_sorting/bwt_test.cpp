@@ -0,0 +1,49 @@
+/*******************************************************************************
+ * tests/suffix_sorting/bwt_test.cpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+#include "mpi/allgather.hpp"
+#include "mpi/distribute_input.hpp"
+#include "mpi/environment.hpp"
+#include "mpi/scan.hpp"
+
+#include "suffix_sorting/bwt.hpp"
+#include "suffix_sorting/difference_cover.hpp"
+
+namespace dsss::tests::suffix_sorting {
+
+TEST(bwt, the_three_brothers) {
+  dsss::mpi::environment env;
+
+  auto local_slice = dsss::mpi::distribute_string(
+    "test_data/the_three_brothers.txt", 0, env);
+  auto text = dsss::mpi::allgatherv(local_slice.string, env);
+  auto sa = dsss::suffix_sorting::dcx<std::size_t, 3>(
+    dsss::distributed_string { local_slice.offset, local_slice.string });
+  auto [ bwt, primary_index ] =
+    dsss::suffix_sorting::bwt(sa, local_slice.string);
+  ASSERT_EQ(sa.size(), bwt.size());
+
+  auto all_sa = dsss::mpi::allgatherv(sa, env);
+  ASSERT_EQ(std::size_t(0), all_sa[primary_index]);
+
+  std::size_t local_size = bwt.size();
+  std::size_t offset = dsss::mpi::ex_prefix_sum(local_size, env);
+  for (std::size_t i = 0; i < local_size; ++i) {
+    const std::size_t pos = all_sa[offset + i];
+    ASSERT_EQ(text[(pos > 0 ? pos : text.size()) - 1], bwt[i])
+      << "i=" << offset + i;
+  }
+}
+
+} // namespace dsss::tests::suffix_sorting
+
+/******************************************************************************/
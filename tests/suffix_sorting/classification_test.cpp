@@ -11,6 +11,12 @@
 #include <cstdint>
 #include <fstream>
 #include <limits>
+#include <random>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
 
 #include "mpi/distribute_input.hpp"
 #include "mpi/environment.hpp"
@@ -128,12 +134,12 @@ void check_borders(std::vector<unsigned char>& original_text,
 
 }
 
-TEST(classification, idx_b_star_substrings) {
+void check_the_three_brothers(const std::size_t halo_size) {
   dsss::mpi::environment env;
 
   // Dirstibute the input and compute the classification
   auto local_slice = dsss::mpi::distribute_string(
-    "test_data/the_three_brothers.txt", 0, env);
+    "test_data/the_three_brothers.txt", 0, halo_size, env);
 
   auto [ bs_substrings, b_array ] = dsss::suffix_sorting::
     idx_b_star_substrings<std::size_t>(local_slice);
@@ -165,6 +171,161 @@ TEST(classification, idx_b_star_substrings) {
   }
 }
 
+void check_substring_views(const std::size_t halo_size) {
+  dsss::mpi::environment env;
+
+  auto local_slice = dsss::mpi::distribute_string(
+    "test_data/the_three_brothers.txt", 0, halo_size, env);
+
+  auto [ bs_substrings, b_array ] = dsss::suffix_sorting::
+    idx_b_star_substrings<std::size_t>(local_slice);
+  auto [ bs_views, views_b_array ] = dsss::suffix_sorting::
+    idx_b_star_substring_views<std::size_t>(local_slice.string,
+      local_slice.offset, local_slice.halo, env);
+
+  // The views contain the same substrings as the copies
+  ASSERT_EQ(bs_substrings.size(), bs_views.size());
+  for (std::size_t i = 0; i < bs_views.size(); ++i) {
+    const auto bs = bs_substrings[i];
+    const auto view = bs_views[i];
+    ASSERT_EQ(bs.index, view.index);
+    ASSERT_EQ(dsss::string_length(bs), dsss::string_length(view));
+    for (std::size_t j = 0; j < view.length; ++j) {
+      ASSERT_EQ(bs.string[j], view[j]);
+    }
+    ASSERT_EQ(dsss::char_type(0), view[view.length]);
+  }
+
+  std::ifstream stream("test_data/the_three_brothers.txt");
+  stream.ignore(std::numeric_limits<std::streamsize>::max());
+  std::size_t file_size = stream.gcount();
+  stream.clear();
+  stream.seekg(0, std::ios::beg);
+  std::vector<unsigned char> compare_to(file_size);
+  stream.read(reinterpret_cast<char*>(compare_to.data()), file_size);
+  stream.close();
+
+  if (env.rank() == 0) {
+    check_borders(compare_to, views_b_array);
+  }
+}
+
+void check_substring_pieces(const std::size_t max_length) {
+  dsss::mpi::environment env;
+
+  auto local_slice = dsss::mpi::distribute_string(
+    "test_data/the_three_brothers.txt", 0, dsss::mpi::default_halo_size, env);
+
+  auto [ bs_views, b_array ] = dsss::suffix_sorting::
+    idx_b_star_substring_views<std::size_t>(local_slice.string,
+      local_slice.offset, local_slice.halo, env);
+  auto [ pieces, pieces_b_array, is_b_star ] = dsss::suffix_sorting::
+    idx_b_star_substring_pieces<std::size_t>(local_slice.string,
+      local_slice.offset, local_slice.halo, max_length, env);
+
+  // Joining the pieces (which overlap by two characters) of each
+  // B*-substring results in the B*-substring
+  ASSERT_EQ(pieces.size(), is_b_star.size());
+  std::size_t piece = 0;
+  for (std::size_t i = 0; i < bs_views.size(); ++i) {
+    const auto view = bs_views[i];
+    ASSERT_LT(piece, pieces.size());
+    ASSERT_TRUE(is_b_star[piece]);
+    ASSERT_EQ(view.index, pieces[piece].index);
+    std::size_t pos = 0;
+    do {
+      const auto cur_piece = pieces[piece];
+      ASSERT_LE(cur_piece.length, max_length);
+      ASSERT_GE(cur_piece.length, std::size_t(3));
+      ASSERT_EQ(view.index + pos, cur_piece.index);
+      for (std::size_t j = 0; j < cur_piece.length; ++j) {
+        ASSERT_EQ(view[pos + j], cur_piece[j]);
+      }
+      pos += cur_piece.length - 2;
+      ++piece;
+    } while (piece < pieces.size() && !is_b_star[piece]);
+    ASSERT_EQ(view.length, pos + 2);
+  }
+  ASSERT_EQ(piece, pieces.size());
+}
+
+TEST(classification, idx_b_star_substrings) {
+  check_the_three_brothers(0);
+}
+
+TEST(classification, idx_b_star_substrings_halo) {
+  // The halo contains the leftmost B*-substrings of (almost) all PEs ...
+  check_the_three_brothers(dsss::mpi::default_halo_size);
+  // ... or only of some PEs
+  check_the_three_brothers(8);
+}
+
+// Classifies a text with runs of equal characters, which span multiple
+// chunks. The longest run contains whole chunks.
+void check_long_runs() {
+  dsss::mpi::environment env;
+
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<std::uint64_t> char_dist('a', 'c');
+  std::uniform_int_distribution<std::size_t> length_dist(1, 1000);
+  std::vector<unsigned char> text;
+  while (text.size() < 40000) {
+    text.resize(text.size() + length_dist(gen),
+                static_cast<unsigned char>(char_dist(gen)));
+    if (text.size() > 20000 && text.size() < 21000) {
+      text.resize(text.size() + 5000, 'b');
+    }
+  }
+  auto [ offset, local_size ] = dsss::mpi::text_slice(text.size(), env);
+  dsss::distributed_string local_slice { offset,
+    std::vector<dsss::char_type>(text.begin() + offset,
+                                 text.begin() + offset + local_size) };
+
+  auto [ bs_substrings, b_array ] = dsss::suffix_sorting::
+    idx_b_star_substrings<std::size_t>(local_slice);
+  for (const auto& bs : bs_substrings) {
+    for (std::size_t i = 0; i < dsss::string_length(bs.string); ++i) {
+      ASSERT_EQ(text[bs.index + i], bs.string[i]);
+    }
+  }
+
+  auto all_bs_substrings =
+    dsss::mpi::allgather_strings(bs_substrings.data_container());
+  if (env.rank() == 0) {
+    check_b_star_substrings(text, all_bs_substrings);
+    check_borders(text, b_array);
+  }
+}
+
+TEST(classification, multiple_chunks) {
+  // Each PE classifies its slice in multiple chunks
+  const std::int64_t chunk_size =
+    dsss::suffix_sorting::min_classification_chunk_size;
+  dsss::suffix_sorting::min_classification_chunk_size = 1;
+#if defined(_OPENMP)
+  const std::int32_t threads = omp_get_max_threads();
+  omp_set_num_threads(16);
+#endif
+  check_the_three_brothers(0);
+  check_the_three_brothers(dsss::mpi::default_halo_size);
+  check_substring_views(0);
+  check_long_runs();
+#if defined(_OPENMP)
+  omp_set_num_threads(threads);
+#endif
+  dsss::suffix_sorting::min_classification_chunk_size = chunk_size;
+}
+
+TEST(classification, idx_b_star_substring_views) {
+  check_substring_views(0);
+  check_substring_views(dsss::mpi::default_halo_size);
+}
+
+TEST(classification, idx_b_star_substring_pieces) {
+  check_substring_pieces(3);
+  check_substring_pieces(8);
+}
+
 } // namespace dsss::tests::suffix_sorting
 
 /******************************************************************************/
@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * tests/suffix_sorting/difference_cover_test.cpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <fstream>
+#include <limits>
+
+#include "mpi/allgather.hpp"
+#include "mpi/distribute_data.hpp"
+#include "mpi/distribute_input.hpp"
+#include "mpi/environment.hpp"
+#include "mpi/scan.hpp"
+
+#include "suffix_sorting/difference_cover.hpp"
+
+namespace dsss::tests::suffix_sorting {
+
+std::vector<std::size_t> load_reference_sa(const std::string& path) {
+  std::ifstream stream(path, std::ios::binary);
+  stream.ignore(std::numeric_limits<std::streamsize>::max());
+  std::size_t file_size = stream.gcount();
+  stream.clear();
+  stream.seekg(0, std::ios::beg);
+  std::vector<std::size_t> sa(file_size / sizeof(std::size_t));
+  stream.read(reinterpret_cast<char*>(sa.data()), file_size);
+  stream.close();
+  return sa;
+}
+
+template <std::size_t X>
+void check_dcx_the_three_brothers() {
+  dsss::mpi::environment env;
+
+  auto local_slice = dsss::mpi::distribute_string(
+    "test_data/the_three_brothers.txt", 0, env);
+  auto sa = dsss::suffix_sorting::dcx<std::size_t, X>(std::move(local_slice));
+  sa = dsss::mpi::distribute_data(sa, env);
+
+  auto compare_to = load_reference_sa(
+    "test_data/the_three_brothers_size_t_sa");
+  std::size_t local_size = sa.size();
+  std::size_t offset = dsss::mpi::ex_prefix_sum(local_size, env);
+  for (std::size_t i = 0; i < local_size; ++i) {
+    ASSERT_EQ(compare_to[offset + i], sa[i]) << "X=" << X << " i=" << i;
+  }
+}
+
+TEST(difference_cover, the_three_brothers) {
+  check_dcx_the_three_brothers<3>();
+  check_dcx_the_three_brothers<7>();
+  check_dcx_the_three_brothers<13>();
+  check_dcx_the_three_brothers<21>();
+}
+
+template <std::size_t X>
+void check_dcx_periodic() {
+  dsss::mpi::environment env;
+
+  // A periodic text requires multiple levels of recursion.
+  std::vector<std::uint16_t> local_text;
+  for (std::size_t i = 0; i < 1000; ++i) {
+    local_text.emplace_back(1 + (i % 3 == 2));
+  }
+  auto text = dsss::mpi::allgatherv(local_text, env);
+  auto sa = dsss::suffix_sorting::dcx_sort<std::size_t, X>(local_text, env);
+  sa = dsss::mpi::distribute_data(sa, env);
+
+  auto compare_to =
+    dsss::suffix_sorting::dcx_base_case<std::size_t>(text);
+  std::size_t local_size = sa.size();
+  std::size_t offset = dsss::mpi::ex_prefix_sum(local_size, env);
+  for (std::size_t i = 0; i < local_size; ++i) {
+    ASSERT_EQ(compare_to[offset + i], sa[i]) << "X=" << X << " i=" << i;
+  }
+}
+
+TEST(difference_cover, periodic_text) {
+  check_dcx_periodic<3>();
+  check_dcx_periodic<7>();
+  check_dcx_periodic<13>();
+  check_dcx_periodic<21>();
+}
+
+} // namespace dsss::tests::suffix_sorting
+
+/******************************************************************************/
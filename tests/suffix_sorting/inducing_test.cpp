@@ -0,0 +1,92 @@
+/*******************************************************************************
+ * tests/suffix_sorting/inducing_test.cpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "mpi/allgather.hpp"
+#include "mpi/distribute_data.hpp"
+#include "mpi/environment.hpp"
+#include "mpi/scan.hpp"
+
+#include "suffix_sorting/difference_cover.hpp"
+#include "suffix_sorting/inducing.hpp"
+#include "util/uint_types.hpp"
+
+namespace dsss::tests::suffix_sorting {
+
+template <typename CharType>
+void check_inducing(std::vector<CharType> local_text) {
+  dsss::mpi::environment env;
+
+  auto text = dsss::mpi::allgatherv(local_text, env);
+  auto sa = dsss::suffix_sorting::inducing<dsss::uint40, CharType>(
+    std::move(local_text));
+  sa = dsss::mpi::distribute_data(sa, env);
+
+  auto compare_to =
+    dsss::suffix_sorting::dcx_base_case<dsss::uint40>(text);
+  std::size_t local_size = sa.size();
+  std::size_t offset = dsss::mpi::ex_prefix_sum(local_size, env);
+  for (std::size_t i = 0; i < local_size; ++i) {
+    ASSERT_EQ(std::uint64_t(compare_to[offset + i]), std::uint64_t(sa[i]))
+      << "i=" << i;
+  }
+}
+
+template <typename CharType>
+void check_integer_alphabet(const std::uint64_t max_char,
+  const std::uint64_t period) {
+  dsss::mpi::environment env;
+
+  // Only a few of all possible characters occur in the text.
+  std::mt19937 gen(env.rank());
+  std::uniform_int_distribution<std::uint64_t> dist(0, 63);
+  std::vector<CharType> local_text;
+  for (std::size_t i = 0; i < 5000; ++i) {
+    local_text.emplace_back(1 + ((dist(gen) * max_char / 64) % period));
+  }
+  check_inducing(std::move(local_text));
+}
+
+TEST(inducing, byte_alphabet) {
+  check_integer_alphabet<std::uint8_t>(255, 255);
+  check_integer_alphabet<std::uint8_t>(255, 32);
+}
+
+TEST(inducing, integer_alphabet) {
+  check_integer_alphabet<std::uint16_t>(65534, 65534);
+  check_integer_alphabet<std::uint16_t>(65534, 2048);
+  check_integer_alphabet<std::uint32_t>(4000000000, 4000000000);
+}
+
+TEST(inducing, long_runs) {
+  dsss::mpi::environment env;
+
+  // Long runs of equal characters, which are induced at once. The slice of
+  // each PE begins and ends with a run of the same character, hence, these
+  // runs span two PEs. The runs are short enough that each slice still
+  // contains B*-suffixes.
+  std::mt19937 gen(env.rank());
+  std::uniform_int_distribution<std::uint64_t> char_dist(1, 3);
+  std::uniform_int_distribution<std::size_t> length_dist(1, 1000);
+  std::vector<std::uint8_t> local_text(1000, 2);
+  while (local_text.size() < 9000) {
+    local_text.resize(local_text.size() + length_dist(gen), char_dist(gen));
+  }
+  local_text.resize(10000, 2);
+  check_inducing(std::move(local_text));
+}
+
+} // namespace dsss::tests::suffix_sorting
+
+/******************************************************************************/
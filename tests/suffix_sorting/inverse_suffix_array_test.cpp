@@ -0,0 +1,59 @@
+/*******************************************************************************
+ * tests/suffix_sorting/inverse_suffix_array_test.cpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+#include "mpi/allgather.hpp"
+#include "mpi/distribute_data.hpp"
+#include "mpi/distribute_input.hpp"
+#include "mpi/environment.hpp"
+#include "mpi/scan.hpp"
+
+#include "suffix_sorting/difference_cover.hpp"
+#include "suffix_sorting/inverse_suffix_array.hpp"
+#include "suffix_sorting/prefix_doubling.hpp"
+#include "util/uint_types.hpp"
+
+namespace dsss::tests::suffix_sorting {
+
+TEST(inverse_suffix_array, the_three_brothers) {
+  dsss::mpi::environment env;
+
+  auto local_slice = dsss::mpi::distribute_string(
+    "test_data/the_three_brothers.txt", 0, env);
+  auto sa = dsss::suffix_sorting::dcx<dsss::uint40, 3>(
+    dsss::distributed_string { local_slice.offset, local_slice.string });
+  auto isa = dsss::suffix_sorting::inverse_suffix_array(sa);
+
+  // The ISA has the same distribution as the text.
+  auto distributed_isa = dsss::mpi::distribute_data(isa, env);
+  ASSERT_EQ(distributed_isa.size(), isa.size());
+
+  auto all_sa = dsss::mpi::allgatherv(sa, env);
+  std::size_t local_size = isa.size();
+  std::size_t offset = dsss::mpi::ex_prefix_sum(local_size, env);
+  for (std::size_t i = 0; i < local_size; ++i) {
+    ASSERT_EQ(offset + i, std::size_t(all_sa[isa[i]])) << "i=" << offset + i;
+  }
+
+  // Prefix doubling can return the ISA directly.
+  auto doubling_isa = dsss::suffix_sorting::prefix_doubling_discarding<
+    dsss::uint40, true>(std::move(local_slice));
+  doubling_isa = dsss::mpi::distribute_data(doubling_isa, env);
+  ASSERT_EQ(isa.size(), doubling_isa.size());
+  for (std::size_t i = 0; i < local_size; ++i) {
+    ASSERT_EQ(std::size_t(isa[i]), std::size_t(doubling_isa[i]))
+      << "i=" << offset + i;
+  }
+}
+
+} // namespace dsss::tests::suffix_sorting
+
+/******************************************************************************/
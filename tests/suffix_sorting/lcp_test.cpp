@@ -0,0 +1,101 @@
+/*******************************************************************************
+ * tests/suffix_sorting/lcp_test.cpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <fstream>
+#include <limits>
+
+#include "mpi/allgather.hpp"
+#include "mpi/distribute_data.hpp"
+#include "mpi/distribute_input.hpp"
+#include "mpi/environment.hpp"
+#include "mpi/scan.hpp"
+
+#include "suffix_sorting/difference_cover.hpp"
+#include "suffix_sorting/lcp.hpp"
+
+namespace dsss::tests::suffix_sorting {
+
+std::vector<std::size_t> naive_lcp(const std::vector<dsss::char_type>& text,
+  const std::vector<std::size_t>& sa) {
+
+  std::vector<std::size_t> lcp(sa.size(), 0);
+  for (std::size_t i = 1; i < sa.size(); ++i) {
+    while (sa[i] + lcp[i] < text.size() && sa[i - 1] + lcp[i] < text.size() &&
+           text[sa[i] + lcp[i]] == text[sa[i - 1] + lcp[i]]) {
+      ++lcp[i];
+    }
+  }
+  return lcp;
+}
+
+void check_lcp(dsss::distributed_string&& local_slice) {
+  dsss::mpi::environment env;
+
+  auto text = dsss::mpi::allgatherv(local_slice.string, env);
+  auto sa = dsss::suffix_sorting::dcx<std::size_t, 3>(
+    dsss::distributed_string { local_slice.offset, local_slice.string });
+  auto lcp = dsss::suffix_sorting::lcp_array(sa, local_slice.string);
+  ASSERT_EQ(sa.size(), lcp.size());
+
+  auto all_sa = dsss::mpi::allgatherv(sa, env);
+  auto compare_to = naive_lcp(text, all_sa);
+  std::size_t local_size = lcp.size();
+  std::size_t offset = dsss::mpi::ex_prefix_sum(local_size, env);
+  for (std::size_t i = 0; i < local_size; ++i) {
+    ASSERT_EQ(compare_to[offset + i], lcp[i]) << "i=" << offset + i;
+  }
+}
+
+TEST(lcp, the_three_brothers) {
+  check_lcp(dsss::mpi::distribute_string(
+    "test_data/the_three_brothers.txt", 0));
+}
+
+TEST(lcp, repetitive_text) {
+  dsss::mpi::environment env;
+
+  // Long common prefixes and a single irreducible value per period
+  std::vector<dsss::char_type> local_text;
+  for (std::size_t i = 0; i < 2000; ++i) {
+    local_text.emplace_back('a' + ((i % 7) == 3));
+  }
+  std::size_t local_size = local_text.size();
+  std::size_t offset = dsss::mpi::ex_prefix_sum(local_size, env);
+  check_lcp(dsss::distributed_string { offset, local_text });
+}
+
+TEST(lcp, fewer_suffixes_than_pes) {
+  dsss::mpi::environment env;
+
+  // The whole text and its suffix array are on the first PE. With more PEs
+  // than suffixes, the last PEs do not get any suffixes.
+  const std::vector<dsss::char_type> text = { 'b', 'a', 'b' };
+  const std::vector<std::size_t> all_sa = { 1, 2, 0 };
+  std::vector<dsss::char_type> local_text;
+  std::vector<std::size_t> sa;
+  if (env.rank() == 0) {
+    local_text = text;
+    sa = all_sa;
+  }
+  auto lcp = dsss::suffix_sorting::lcp_array(sa, local_text);
+  ASSERT_EQ(sa.size(), lcp.size());
+
+  auto compare_to = naive_lcp(text, all_sa);
+  auto all_lcp = dsss::mpi::allgatherv(lcp, env);
+  ASSERT_EQ(compare_to.size(), all_lcp.size());
+  for (std::size_t i = 0; i < all_lcp.size(); ++i) {
+    ASSERT_EQ(compare_to[i], all_lcp[i]) << "i=" << i;
+  }
+}
+
+} // namespace dsss::tests::suffix_sorting
+
+/******************************************************************************/
@@ -0,0 +1,165 @@
+/*******************************************************************************
+ * tests/suffix_sorting/prefix_doubling_test.cpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "mpi/allgather.hpp"
+#include "mpi/distribute_data.hpp"
+#include "mpi/distribute_input.hpp"
+#include "mpi/environment.hpp"
+#include "mpi/scan.hpp"
+
+#include "suffix_sorting/difference_cover.hpp"
+#include "suffix_sorting/prefix_doubling.hpp"
+#include "util/spill_vector.hpp"
+#include "util/uint_types.hpp"
+
+namespace dsss::tests::suffix_sorting {
+
+TEST(spill_vector, read_chunks) {
+  dsss::spill_config config;
+  config.memory_budget = 10 * sizeof(std::uint64_t);
+
+  // Both vectors (and those of the other PEs) get their own scratch file.
+  dsss::spill_vector<std::uint64_t> first(config, "spill_vector_test");
+  dsss::spill_vector<std::uint64_t> second(config, "spill_vector_test");
+  for (std::uint64_t i = 0; i < 1005; ++i) {
+    first.emplace_back(i);
+    second.emplace_back(2 * i);
+  }
+  ASSERT_EQ(first.size(), 1005ULL);
+  ASSERT_EQ(first.spilled(), 1000ULL);
+  ASSERT_EQ(first.chunk_size(), 10ULL);
+
+  // Chunks can consist of spilled and buffered elements.
+  for (std::size_t begin = 0; begin < 1010; begin += 7) {
+    auto chunk = first.read(begin, 7);
+    ASSERT_EQ(chunk.size(), std::min<std::size_t>(7, 1005 - std::min<
+      std::size_t>(begin, 1005)));
+    for (std::size_t i = 0; i < chunk.size(); ++i) {
+      ASSERT_EQ(chunk[i], begin + i);
+    }
+  }
+
+  auto all = second.release();
+  ASSERT_EQ(all.size(), 1005ULL);
+  for (std::size_t i = 0; i < all.size(); ++i) {
+    ASSERT_EQ(all[i], 2 * i);
+  }
+  ASSERT_EQ(second.size(), 0ULL);
+
+  // The scratch file is reused after the vector has been emptied.
+  for (std::uint64_t i = 0; i < 25; ++i) {
+    second.emplace_back(3 * i);
+  }
+  ASSERT_EQ(second.spilled(), 20ULL);
+  auto chunk = second.read(15, 10);
+  ASSERT_EQ(chunk.size(), 10ULL);
+  for (std::size_t i = 0; i < chunk.size(); ++i) {
+    ASSERT_EQ(chunk[i], 3 * (15 + i));
+  }
+}
+
+TEST(prefix_doubling, memory_budget) {
+  dsss::mpi::environment env;
+  const std::string path = "test_data/the_three_brothers.txt";
+
+  auto sa = dsss::suffix_sorting::dcx<std::size_t, 3>(
+    dsss::mpi::distribute_string(path, 0, env));
+  sa = dsss::mpi::distribute_data(sa, env);
+  std::size_t local_size = sa.size();
+  std::size_t offset = dsss::mpi::ex_prefix_sum(local_size, env);
+
+  // Most tuples are discarded and spilled before the ranks are unique.
+  dsss::suffix_sorting::doubling_config config;
+  config.spill.memory_budget = 256;
+
+  auto doubling_sa = dsss::suffix_sorting::prefix_doubling_discarding<
+    dsss::uint40>(dsss::mpi::distribute_string(path, 0, env), config);
+  doubling_sa = dsss::mpi::distribute_data(doubling_sa, env);
+  ASSERT_EQ(sa.size(), doubling_sa.size());
+  for (std::size_t i = 0; i < local_size; ++i) {
+    ASSERT_EQ(sa[i], std::size_t(doubling_sa[i])) << "i=" << offset + i;
+  }
+
+  auto isa = dsss::suffix_sorting::prefix_doubling_discarding<
+    dsss::uint40, true>(dsss::mpi::distribute_string(path, 0, env), config);
+  isa = dsss::mpi::distribute_data(isa, env);
+  auto all_sa = dsss::mpi::allgatherv(sa, env);
+  ASSERT_EQ(sa.size(), isa.size());
+  for (std::size_t i = 0; i < local_size; ++i) {
+    ASSERT_EQ(offset + i, all_sa[isa[i]]) << "i=" << offset + i;
+  }
+}
+
+// Periodic text whose ranks are unique only after many doubling iterations
+dsss::distributed_string periodic_string(const std::size_t size,
+  dsss::mpi::environment env = dsss::mpi::environment()) {
+  auto [ offset, local_size ] = dsss::mpi::text_slice(size, env);
+  std::vector<dsss::char_type> text;
+  for (std::size_t i = offset; i < offset + local_size; ++i) {
+    text.emplace_back(dsss::char_type('a' + (i % 397) * 7919 % 13));
+  }
+  return dsss::distributed_string { offset, text };
+}
+
+TEST(prefix_doubling, resume_checkpoint) {
+  dsss::mpi::environment env;
+
+  auto sa = dsss::suffix_sorting::prefix_doubling_discarding<dsss::uint40>(
+    periodic_string(4000, env));
+  sa = dsss::mpi::distribute_data(sa, env);
+
+  // Each checkpoint only contains the tuples discarded since the last one.
+  dsss::suffix_sorting::doubling_config config;
+  config.spill.memory_budget = 256;
+  config.checkpoint.directory = ".";
+  config.checkpoint.doubling_interval = 1;
+  config.checkpoint.resume = true;
+  config.checkpoint_name = "prefix_doubling_test";
+  auto resume = [&](const std::size_t stop_iteration,
+                    const std::size_t size) {
+    config.stop_iteration = stop_iteration;
+    auto result = dsss::suffix_sorting::prefix_doubling_discarding<
+      dsss::uint40>(periodic_string(size, env), config);
+    return dsss::mpi::distribute_data(result, env);
+  };
+
+  // Interrupt the computation twice and resume it
+  ASSERT_TRUE(resume(6, 4000).empty());
+  ASSERT_TRUE(resume(9, 4000).empty());
+  auto resumed_sa = resume(0, 4000);
+  ASSERT_EQ(sa.size(), resumed_sa.size());
+  for (std::size_t i = 0; i < sa.size(); ++i) {
+    ASSERT_EQ(std::size_t(sa[i]), std::size_t(resumed_sa[i])) << "i=" << i;
+  }
+  std::ifstream removed(config.checkpoint.path(config.checkpoint_name));
+  ASSERT_FALSE(removed.good());
+
+  // A checkpoint of another text is ignored
+  auto other_sa = dsss::suffix_sorting::prefix_doubling_discarding<
+    dsss::uint40>(periodic_string(2000, env));
+  other_sa = dsss::mpi::distribute_data(other_sa, env);
+  ASSERT_TRUE(resume(6, 4000).empty());
+  auto ignored_sa = resume(0, 2000);
+  ASSERT_EQ(other_sa.size(), ignored_sa.size());
+  for (std::size_t i = 0; i < other_sa.size(); ++i) {
+    ASSERT_EQ(std::size_t(other_sa[i]), std::size_t(ignored_sa[i]))
+      << "i=" << i;
+  }
+}
+
+} // namespace dsss::tests::suffix_sorting
+
+/******************************************************************************/
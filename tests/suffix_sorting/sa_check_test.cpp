@@ -0,0 +1,75 @@
+/*******************************************************************************
+ * tests/suffix_sorting/sa_check_test.cpp
+ *
+ * Copyright (C) 2018 Florian Kurpicz <florian.kurpicz@tu-dortmund.de>
+ *
+ * All rights reserved. Published under the BSD-2 license in the LICENSE file.
+ ******************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "mpi/distribute_input.hpp"
+#include "mpi/environment.hpp"
+
+#include "suffix_sorting/difference_cover.hpp"
+#include "suffix_sorting/sa_check.hpp"
+#include "util/uint_types.hpp"
+
+namespace dsss::tests::suffix_sorting {
+
+TEST(sa_check, probabilistic) {
+  dsss::mpi::environment env;
+
+  auto local_slice = dsss::mpi::distribute_string(
+    "test_data/the_three_brothers.txt", 0, env);
+  auto text = local_slice.string;
+  auto sa = dsss::suffix_sorting::dcx<dsss::uint40, 3>(
+    dsss::distributed_string { local_slice.offset, local_slice.string });
+
+  auto check = [&](std::vector<dsss::uint40> to_check, const double ratio) {
+    auto local_text = text;
+    return dsss::suffix_sorting::check_probabilistic(to_check, local_text,
+                                                     ratio);
+  };
+
+  ASSERT_TRUE(check(sa, 1.0));
+  ASSERT_TRUE(check(sa, 0.01));
+
+  // Two swapped neighbors are found if all pairs are compared.
+  auto swapped = sa;
+  if (env.rank() == 0) {
+    std::swap(swapped[10], swapped[11]);
+  }
+  ASSERT_FALSE(check(swapped, 1.0));
+
+  // An SA that is not a permutation is always found.
+  auto duplicate = sa;
+  if (env.rank() == 0) {
+    duplicate[10] = duplicate[11];
+  }
+  ASSERT_FALSE(check(duplicate, 0.0));
+}
+
+TEST(sa_check, fewer_suffixes_than_pes) {
+  dsss::mpi::environment env;
+
+  // With more PEs than suffixes, the last PEs do not get any suffixes.
+  auto check = [&](const std::vector<std::size_t>& all_sa) {
+    std::vector<dsss::char_type> local_text;
+    std::vector<std::size_t> sa;
+    if (env.rank() == 0) {
+      local_text = { 'b', 'a', 'b' };
+      sa = all_sa;
+    }
+    return dsss::suffix_sorting::check_probabilistic(sa, local_text, 1.0);
+  };
+  ASSERT_TRUE(check({ 1, 2, 0 }));
+  ASSERT_FALSE(check({ 2, 1, 0 }));
+}
+
+} // namespace dsss::tests::suffix_sorting
+
+/******************************************************************************/